@@ -0,0 +1,252 @@
+/*
+		File: Benchmark.c
+		Group 17
+		Andrew Nguyen, Anton Tran, Tommy Troung, Abass Mir
+		Functionallity: Main program of the ST7735_Benchmark target.
+		Times the ST7735 drawing primitives over fixed workloads with
+		the DWT cycle counter and reports the results over UART0.
+*/ 
+
+// Benchmark.c
+// Runs on TM4C123
+// Build the ST7735_Benchmark target (defines BENCHMARK, which leaves
+// main() out of WeatherDisplay.c, and ST7735_STATS=1) and open a
+// terminal on the LaunchPad virtual COM port at 115200 bps.
+// For each workload one line is printed:
+//   name  cycles  bytes  pixels/s
+// Cycles include waiting for any uDMA stream the workload started.
+// Pixels/s counts the pixels the workload covers on the screen.
+
+#include <stdint.h>
+#include "ST7735.h"
+#include "Clock.h"
+#include "CycleCount.h"
+#include "UART.h"
+#include "Format.h"
+#include "bitmaps.h"
+#include "bitmaps_rle.h"
+
+void drawScreen(int state);      // WeatherDisplay.c
+#define RAINY_SCREEN 2           // its WeatherState RAINY
+
+typedef struct {
+  char *name;
+  void (*run)(void);
+  uint32_t pixels;               // pixels covered by one run
+} Benchmark;
+
+static void benchFillScreen(void){
+  ST7735_FillScreen(ST7735_BLUE);
+}
+
+static void benchFillRect(void){ // 100 small rectangles, below the uDMA cutoff
+  for(int i = 0; i < 100; i++){
+    ST7735_FillRect((i%20)*6, (i/20)*6, 5, 5, ST7735_RED);
+  }
+}
+
+static void benchQueueFillRect(void){ // the same 100 rectangles through the draw queue
+  ST7735_DrawOp op = {ST7735_OP_FILLRECT, 0, 0, 0, 5, 5, ST7735_RED, 0, 0};
+  for(int i = 0; i < 100; i++){
+    op.x = (i%20)*6;
+    op.y = (i/20)*6;
+    while(ST7735_Enqueue(&op) == 0){}; // a real caller would do other work here
+  }
+}
+
+static void benchDrawBitmap(void){ // raw RGB565 20x20, 24 copies
+  for(int i = 0; i < 24; i++){
+    ST7735_DrawBitmap((i%6)*20, (i/6)*20 + 19, sunny_day, 20, 20);
+  }
+}
+
+static void benchDrawRLEImage(void){ // encoded 20x20 at 2x, 12 copies
+  for(int i = 0; i < 12; i++){
+    ST7735_DrawRLEImage((i%3)*40, (i/3)*40, &sunny_day_img, 2);
+  }
+}
+
+static void benchDrawChar(void){ // 100 characters at size 2
+  for(int i = 0; i < 100; i++){
+    ST7735_DrawChar((i%10)*12, (i/10)*16, 'A' + i%26, ST7735_WHITE, ST7735_BLACK, 2);
+  }
+}
+
+static void benchDrawCharS(void){ // same 100 characters pixel by pixel
+  for(int i = 0; i < 100; i++){
+    ST7735_DrawCharS((i%10)*12, (i/10)*16, 'A' + i%26, ST7735_WHITE, ST7735_BLACK, 2);
+  }
+}
+
+static void benchDrawText(void){ // the same 100 characters as 10 strings
+  static char *rows[10] = {"ABCDEFGHIJ", "KLMNOPQRST", "UVWXYZABCD", "EFGHIJKLMN", "OPQRSTUVWX",
+                           "YZABCDEFGH", "IJKLMNOPQR", "STUVWXYZAB", "CDEFGHIJKL", "MNOPQRSTUV"};
+  for(int i = 0; i < 10; i++){
+    ST7735_DrawText(0, i*16, rows[i], ST7735_WHITE, ST7735_BLACK, 2);
+  }
+}
+
+static void benchDrawLine(void){ // 32 lines fanned out from the center
+  for(int i = 0; i < 32; i++){
+    ST7735_DrawLine(64, 80, (i < 16) ? i*8 : 127, (i < 16) ? 0 : (i-16)*10, ST7735_YELLOW);
+  }
+}
+
+static void benchCircles(void){ // outline and filled, radius 40
+  ST7735_DrawCircle(64, 40, 30, ST7735_WHITE);
+  ST7735_FillCircle(64, 110, 40, ST7735_YELLOW);
+}
+
+static void benchFillTriangle(void){ // 8 sun rays around a 64x64 box
+  static const int8_t ray[8][6] = {
+    {-4,-20, 4,-20, 0,-32}, {14,-17, 17,-14, 23,-23}, {20,-4, 20,4, 32,0},  {17,14, 14,17, 23,23},
+    {4,20, -4,20, 0,32},    {-14,17, -17,14, -23,23}, {-20,4, -20,-4, -32,0}, {-17,-14, -14,-17, -23,-23}};
+  for(int i = 0; i < 8; i++){
+    ST7735_FillTriangle(64+ray[i][0], 80+ray[i][1], 64+ray[i][2], 80+ray[i][3],
+                        64+ray[i][4], 80+ray[i][5], ST7735_YELLOW);
+  }
+}
+
+static void benchTextField(void){ // 3-cell field, then 10 one-digit changes
+  static ST7735_TextField field = {.x = 89, .y = 110, .len = 3, .size = 1,
+                                   .color = ST7735_GREEN, .bgColor = ST7735_BLACK};
+  ST7735_SetTextFieldShown(&field, 0);
+  ST7735_UpdateTextField(&field, " 60");
+  for(int i = 0; i < 10; i++){
+    ST7735_UpdateTextField(&field, (i & 1) ? " 60" : " 61");
+  }
+}
+
+static void benchPlotStream(void){ // 1024 samples of a triangle wave, 8 per column
+  ST7735_PlotStreamInit(0, 255, 8, 0);
+  for(int32_t i = 0; i < 1024; i++){
+    ST7735_PlotStream((i & 0x100) ? (255 - (i & 0xFF)) : (i & 0xFF));
+  }
+}
+
+static void benchRainyScreen(void){
+  drawScreen(RAINY_SCREEN);
+}
+
+#if ST7735_FRAMEBUFFER
+static uint8_t RainyCache[1024];
+static void benchCachedScreen(void){ // screen captured once in main()
+  ST7735_DrawScreen(RainyCache);
+}
+
+static void benchFlushScreen(void){ // compose in RAM, then send the whole screen
+  ST7735_SetFramebuffer(1);
+  drawScreen(RAINY_SCREEN);
+  ST7735_Flush();
+  ST7735_SetFramebuffer(0);
+}
+
+#define BENCH_SPRITES 60
+#define BENCH_FRAMES  10
+static ST7735_Sprite BenchDrops[BENCH_SPRITES];
+static void benchSprites(void){ // 60 1x4 drops falling 3 rows a frame, 10 frames
+  ST7735_SetFramebuffer(1);
+  ST7735_ClearSprites();
+  ST7735_SetSpriteArea(0, 0, 128, 160, ST7735_BLACK);
+  for(int i = 0; i < BENCH_SPRITES; i++){
+    BenchDrops[i] = (ST7735_Sprite){.x = (i*37)%128, .y = (i*53)%150, .w = 1, .h = 4,
+                                    .color = ST7735_CYAN, .visible = 1};
+    (void)ST7735_AddSprite(&BenchDrops[i]);
+  }
+  ST7735_UpdateSprites();
+  for(int f = 0; f < BENCH_FRAMES; f++){
+    for(int i = 0; i < BENCH_SPRITES; i++){
+      BenchDrops[i].y = (BenchDrops[i].y + 3)%150;
+    }
+    ST7735_UpdateSprites();
+  }
+  ST7735_ClearSprites();
+  ST7735_SetFramebuffer(0);
+}
+#endif
+
+static const Benchmark Benchmarks[] = {
+  {"FillScreen",    benchFillScreen,   128*160},
+  {"FillRect x100", benchFillRect,     100*5*5},
+  {"Queue Fill x100", benchQueueFillRect, 100*5*5},
+  {"DrawBitmap x24", benchDrawBitmap,  24*20*20},
+  {"DrawRLE 2x x12", benchDrawRLEImage, 12*40*40},
+  {"DrawChar x100", benchDrawChar,     100*12*16},
+  {"DrawCharS x100", benchDrawCharS,   100*12*16},
+  {"DrawText x10",  benchDrawText,     100*12*16},
+  {"DrawLine x32",  benchDrawLine,     32*100},
+  {"Circles r30+40", benchCircles,     188+5027},
+  {"FillTriangle x8", benchFillTriangle, 8*48},
+  {"TextField 3+10", benchTextField,   13*6*8},
+  {"PlotStream x1024", benchPlotStream, 2*128*128},
+  {"RainyScreen",   benchRainyScreen,  128*160},
+#if ST7735_FRAMEBUFFER
+  {"RainyScreen FB", benchFlushScreen, 128*160},
+  {"Rainy cached",  benchCachedScreen, 128*160},
+  {"Sprites 60x10", benchSprites,      (BENCH_FRAMES+1)*BENCH_SPRITES*4},
+#endif
+};
+#define NUM_BENCHMARKS (sizeof(Benchmarks)/sizeof(Benchmarks[0]))
+
+// Output a string padded with spaces to width characters
+static void outPadded(char *pt, uint32_t width){
+  while(*pt){
+    UART_OutChar(*pt);
+    pt++;
+    if(width) width--;
+  }
+  while(width){
+    UART_OutChar(' ');
+    width--;
+  }
+}
+
+// Output n right-aligned in width characters
+static void outUDecRight(uint32_t n, uint32_t width){
+  char buf[FORMAT_SIZE];                // widths used here are at most 12
+  Format_UDec(buf, n, width);
+  UART_OutString(buf);
+}
+
+int main(void){
+  uint32_t start, cycles, bytes;
+  Clock_Init(Bus80MHz);
+  ST7735_InitR(INITR_REDTAB);
+  ST7735_SetFramebuffer(0);             // time the direct-to-LCD paths
+  UART_Init(Clock_BusHz());
+  CycleCount_Init();
+#if ST7735_FRAMEBUFFER
+  ST7735_SetFramebuffer(1);             // capture the screen for the cached case
+  drawScreen(RAINY_SCREEN);
+  ST7735_CaptureScreen(RainyCache, sizeof(RainyCache));
+  ST7735_SetFramebuffer(0);
+#endif
+
+  UART_OutString("ST7735 benchmark, bus ");
+  UART_OutUDec(Clock_BusHz()/1000000);
+  UART_OutString(" MHz");
+  UART_OutCRLF();
+  UART_OutString("name                  cycles       bytes    pixels/s");
+  UART_OutCRLF();
+
+  for(uint32_t i = 0; i < NUM_BENCHMARKS; i++){
+    ST7735_FillScreen(ST7735_BLACK);    // same starting screen for every run
+    ST7735_DMAWait();
+    bytes = ST7735_BytesSent();
+    start = CycleCount_Now();
+    Benchmarks[i].run();
+    ST7735_DMAWait();
+    cycles = CycleCount_Now() - start;
+    bytes = ST7735_BytesSent() - bytes;
+    outPadded(Benchmarks[i].name, 16);
+    outUDecRight(cycles, 12);
+    outUDecRight(bytes, 12);
+    outUDecRight((uint32_t)((uint64_t)Benchmarks[i].pixels*Clock_BusHz()/(cycles ? cycles : 1)), 12);
+    UART_OutCRLF();
+  }
+
+  ST7735_FillScreen(ST7735_BLACK);
+  ST7735_DrawString(0, 0, "Benchmark done", ST7735_GREEN);
+  ST7735_DrawString(0, 1, "see UART0", ST7735_GREEN);
+  while(1){};
+}
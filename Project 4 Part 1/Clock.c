@@ -0,0 +1,84 @@
+/*
+		File: Clock.c
+		Group 17
+		Andrew Nguyen, Anton Tran, Tommy Troung, Abass Mir
+		Functionallity: Implements the clock configuration module
+		declared in Clock.h on top of PLL_Init.
+*/ 
+
+// Clock.c
+// Runs on TM4C123
+// PLL.c does the register work; this file only keeps track of the
+// frequency it produced so the rest of the program never hard-codes
+// one.
+
+#include <stdint.h>
+#include "Clock.h"
+
+static uint32_t BusHz = CLOCK_PIOSC_HZ;
+
+//------------Clock_Init------------
+// Run the core from the PLL and record the resulting bus frequency.
+// Input: sysdiv  one of the BusXXMHz values in PLL.h, e.g. Bus80MHz
+// Output: none
+void Clock_Init(uint32_t sysdiv){
+  PLL_Init(sysdiv);
+  BusHz = 400000000/(sysdiv + 1);       // bus frequency is 400MHz/(SYSDIV+1)
+}
+
+//------------Clock_BusHz------------
+// Current bus (core) clock frequency.
+// Input: none
+// Output: frequency in Hz
+uint32_t Clock_BusHz(void){
+  return BusHz;
+}
+
+//------------Clock_SSIDivider------------
+// Fastest SSI master clock that does not exceed maxHz, where
+// SSIClk = SysClk/(CPSDVSR*(1+SCR)) with CPSDVSR even, 2 to 254.
+// Input: maxHz    highest SSIClk the device tolerates
+//        cpsdvsr  where to store the prescale divisor
+//        scr      where to store the serial clock rate
+// Output: the resulting SSIClk in Hz
+uint32_t Clock_SSIDivider(uint32_t maxHz, uint32_t *cpsdvsr, uint32_t *scr){
+  uint32_t div = (BusHz + maxHz - 1)/maxHz;  // smallest total divide that is slow enough
+  uint32_t c, s;
+  if(div < 2) div = 2;                  // SSIClk is at most SysClk/2
+  for(c = 2; c <= 254; c = c + 2){      // smallest prescale that leaves SCR in range
+    s = (div + c - 1)/c - 1;
+    if(s <= 255) break;
+  }
+  if(c > 254){                          // maxHz is too low to reach, use the slowest clock
+    c = 254;
+    s = 255;
+  }
+  *cpsdvsr = c;
+  *scr = s;
+  return BusHz/(c*(1 + s));
+}
+
+//------------Clock_Delay1ms------------
+// Busy-wait about n milliseconds at the current bus clock.
+// Input: n  number of milliseconds
+// Output: none
+void Clock_Delay1ms(uint32_t n){uint32_t volatile time;
+  while(n){
+    time = BusHz/1000/CLOCK_LOOP_CYCLES;
+    while(time){
+      time--;
+    }
+    n--;
+  }
+}
+
+//------------Clock_Delay1us------------
+// Busy-wait at least n microseconds at the current bus clock.
+// Input: n  number of microseconds
+// Output: none
+void Clock_Delay1us(uint32_t n){uint32_t volatile time;
+  time = (BusHz/1000000*n + CLOCK_LOOP_CYCLES - 1)/CLOCK_LOOP_CYCLES;
+  while(time){
+    time--;
+  }
+}
@@ -0,0 +1,58 @@
+/*
+		File: Clock.h
+		Group 17
+		Andrew Nguyen, Anton Tran, Tommy Troung, Abass Mir
+		Functionallity: Declares the clock configuration module that
+		brings up the PLL, remembers the bus frequency and derives
+		SSI dividers and software delays from it.
+*/ 
+
+// Clock.h
+// Runs on TM4C123
+// Call Clock_Init() first thing in main(), before any driver that
+// computes a rate from the bus clock (ST7735_Init*, Scheduler_Init,
+// Switch_Init). Without Clock_Init the part runs from the 16 MHz
+// PIOSC and Clock_BusHz() reports that.
+
+#ifndef _CLOCK_H_
+#define _CLOCK_H_
+#include <stdint.h>
+#include "PLL.h"
+
+#define CLOCK_PIOSC_HZ    16000000
+#define CLOCK_LOOP_CYCLES 50      // bus cycles per pass of the Clock_Delay1ms loop
+
+//------------Clock_Init------------
+// Run the core from the PLL and record the resulting bus frequency.
+// Input: sysdiv  one of the BusXXMHz values in PLL.h, e.g. Bus80MHz
+// Output: none
+void Clock_Init(uint32_t sysdiv);
+
+//------------Clock_BusHz------------
+// Current bus (core) clock frequency.
+// Input: none
+// Output: frequency in Hz
+uint32_t Clock_BusHz(void);
+
+//------------Clock_SSIDivider------------
+// Fastest SSI master clock that does not exceed maxHz, where
+// SSIClk = SysClk/(CPSDVSR*(1+SCR)) with CPSDVSR even, 2 to 254.
+// Input: maxHz    highest SSIClk the device tolerates
+//        cpsdvsr  where to store the prescale divisor
+//        scr      where to store the serial clock rate
+// Output: the resulting SSIClk in Hz
+uint32_t Clock_SSIDivider(uint32_t maxHz, uint32_t *cpsdvsr, uint32_t *scr);
+
+//------------Clock_Delay1ms------------
+// Busy-wait about n milliseconds at the current bus clock.
+// Input: n  number of milliseconds
+// Output: none
+void Clock_Delay1ms(uint32_t n);
+
+//------------Clock_Delay1us------------
+// Busy-wait at least n microseconds at the current bus clock.
+// Input: n  number of microseconds
+// Output: none
+void Clock_Delay1us(uint32_t n);
+
+#endif
@@ -0,0 +1,43 @@
+/*
+		File: CycleCount.h
+		Group 17
+		Andrew Nguyen, Anton Tran, Tommy Troung, Abass Mir
+		Functionallity: Cortex-M4 DWT cycle counter access for timing
+		code to the exact bus cycle.
+*/ 
+
+// CycleCount.h
+// Runs on TM4C123
+// CYCCNT counts every core clock cycle and wraps after 2^32 cycles
+// (53 s at 80 MHz). Differences of two readings are correct across one
+// wrap as long as they are taken as uint32_t.
+
+#ifndef _CYCLECOUNT_H_
+#define _CYCLECOUNT_H_
+#include <stdint.h>
+
+#define CORE_DEMCR     (*((volatile uint32_t *)0xE000EDFC))
+#define CORE_DWT_CTRL  (*((volatile uint32_t *)0xE0001000))
+#define CORE_DWT_CYCCNT (*((volatile uint32_t *)0xE0001004))
+#define DEMCR_TRCENA   0x01000000  // enable the DWT and ITM units
+#define DWT_CYCCNTENA  0x00000001  // enable CYCCNT
+
+//------------CycleCount_Init------------
+// Start the DWT cycle counter from 0.
+// Input: none
+// Output: none
+static inline void CycleCount_Init(void){
+  CORE_DEMCR |= DEMCR_TRCENA;
+  CORE_DWT_CYCCNT = 0;
+  CORE_DWT_CTRL |= DWT_CYCCNTENA;
+}
+
+//------------CycleCount_Now------------
+// Current value of the cycle counter.
+// Input: none
+// Output: core clock cycles since CycleCount_Init (mod 2^32)
+static inline uint32_t CycleCount_Now(void){
+  return CORE_DWT_CYCCNT;
+}
+
+#endif
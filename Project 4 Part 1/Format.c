@@ -0,0 +1,95 @@
+/*
+		File: Format.c
+		Group 17
+		Andrew Nguyen, Anton Tran, Tommy Troung, Abass Mir
+		Functionallity: Implements the reentrant decimal number
+		formatters declared in Format.h.
+*/ 
+
+// Format.c
+// Runs on TM4C123
+// The length of the result is found first by comparing against powers
+// of ten, so the digits can be written from the right end of the
+// buffer straight into place.
+
+#include <stdint.h>
+#include "Format.h"
+
+static const uint32_t Pow10[9] = {
+  10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+// n/10 for any 32-bit n: 0xCCCCCCCD/2^35 is 1/10 rounded up, close
+// enough that the truncated product is exact (one UMULL on the M4)
+static uint32_t div10(uint32_t n){
+  return (uint32_t)(((uint64_t)n*0xCCCCCCCDu)>>35);
+}
+
+// Magnitude n, optional sign and point, padded to width
+static uint32_t format(char *buf, uint32_t n, uint32_t negative, uint32_t decimals, uint32_t width){
+  uint32_t digits = 1, len, pad, i, q;
+  char *pt;
+  while((digits < 10) && (n >= Pow10[digits-1])){
+    digits++;
+  }
+  if(decimals > 9) decimals = 9;
+  if(digits <= decimals) digits = decimals + 1; // "0.05"
+  len = negative + digits + (decimals ? 1 : 0);
+  pad = (width > len) ? (width - len) : 0;
+  for(i=0; i<pad; i=i+1){
+    buf[i] = ' ';
+  }
+  pt = &buf[pad + len];
+  *pt = 0;                              // terminate
+  for(i=0; i<digits; i=i+1){
+    if(decimals && (i == decimals)){
+      pt--;
+      *pt = '.';
+    }
+    q = div10(n);
+    pt--;
+    *pt = '0' + (n - 10*q);             // n%10
+    n = q;
+  }
+  if(negative){
+    pt--;
+    *pt = '-';
+  }
+  return pad + len;
+}
+
+//------------Format_UDec------------
+// Unsigned decimal, right-aligned in width characters.
+// Input: buf    where to write the string
+//        n      number to format
+//        width  minimum length, padded with spaces on the left; 0 for none
+// Output: length of the string
+uint32_t Format_UDec(char *buf, uint32_t n, uint8_t width){
+  return format(buf, n, 0, 0, width);
+}
+
+//------------Format_Dec------------
+// Signed decimal, right-aligned in width characters.
+// Input: buf    where to write the string
+//        n      number to format
+//        width  minimum length, padded with spaces on the left; 0 for none
+// Output: length of the string
+uint32_t Format_Dec(char *buf, int32_t n, uint8_t width){
+  return Format_Fixed(buf, n, 0, width);
+}
+
+//------------Format_Fixed------------
+// Signed fixed-point decimal with a given number of digits after the
+// point, right-aligned in width characters; temperatures in tenths of
+// a degree are Format_Fixed(buf, 725, 1, 5) = " 72.5".
+// Input: buf      where to write the string
+//        n        number in units of 10^-decimals
+//        decimals digits after the point, 0 to 9 (0 is Format_Dec)
+//        width    minimum length, padded with spaces on the left; 0 for none
+// Output: length of the string
+uint32_t Format_Fixed(char *buf, int32_t n, uint8_t decimals, uint8_t width){
+  if(n < 0){
+    return format(buf, 0u - (uint32_t)n, 1, decimals, width); // also right for -2^31
+  }
+  return format(buf, n, 0, decimals, width);
+}
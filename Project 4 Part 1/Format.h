@@ -0,0 +1,53 @@
+/*
+		File: Format.h
+		Group 17
+		Andrew Nguyen, Anton Tran, Tommy Troung, Abass Mir
+		Functionallity: Declares the reentrant decimal number
+		formatters used for the LCD and UART output.
+*/ 
+
+// Format.h
+// Runs on TM4C123
+// Each function writes a null terminated string into a buffer the
+// caller provides (usually a local array) and uses no globals, so it
+// may be called from interrupts and tasks at the same time. Digits are
+// taken off with a reciprocal multiply instead of a divide, and there
+// is no recursion.
+
+#ifndef _FORMAT_H_
+#define _FORMAT_H_
+#include <stdint.h>
+
+// Longest result without padding, "-4294967.295" for example, with the
+// terminating null. A buffer must hold FORMAT_SIZE characters and, for
+// a width over FORMAT_SIZE-1, width+1.
+#define FORMAT_SIZE 13
+
+//------------Format_UDec------------
+// Unsigned decimal, right-aligned in width characters.
+// Input: buf    where to write the string
+//        n      number to format
+//        width  minimum length, padded with spaces on the left; 0 for none
+// Output: length of the string
+uint32_t Format_UDec(char *buf, uint32_t n, uint8_t width);
+
+//------------Format_Dec------------
+// Signed decimal, right-aligned in width characters.
+// Input: buf    where to write the string
+//        n      number to format
+//        width  minimum length, padded with spaces on the left; 0 for none
+// Output: length of the string
+uint32_t Format_Dec(char *buf, int32_t n, uint8_t width);
+
+//------------Format_Fixed------------
+// Signed fixed-point decimal with a given number of digits after the
+// point, right-aligned in width characters; temperatures in tenths of
+// a degree are Format_Fixed(buf, 725, 1, 5) = " 72.5".
+// Input: buf      where to write the string
+//        n        number in units of 10^-decimals
+//        decimals digits after the point, 0 to 9 (0 is Format_Dec)
+//        width    minimum length, padded with spaces on the left; 0 for none
+// Output: length of the string
+uint32_t Format_Fixed(char *buf, int32_t n, uint8_t decimals, uint8_t width);
+
+#endif
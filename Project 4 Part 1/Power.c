@@ -0,0 +1,77 @@
+/*
+		File: Power.c
+		Group 17
+		Andrew Nguyen, Anton Tran, Tommy Troung, Abass Mir
+		Functionallity: Implements the sleep and deep-sleep idle
+		functions declared in Power.h.
+*/ 
+
+// Power.c
+// Runs on TM4C123
+// On waking from deep sleep the hardware switches back to the run
+// mode clock (the PLL at Clock_BusHz()) before the interrupt handler
+// runs.
+
+#include <stdint.h>
+#include "Power.h"
+#include "ST7735.h"
+#include "tm4c123gh6pm.h"
+
+void WaitForInterrupt(void);  // low power mode, in startup.s
+
+#define GPIO_A   0x01               // Port A bit in the clock gating registers
+#define GPIO_F   0x20               // Port F bit
+#define TIMER_1  0x02               // Timer1 bit
+#define TIMER_2  0x04               // Timer2 bit
+#define UDMA     0x01               // uDMA bit
+#define UART_0   0x01               // UART0 bit
+
+//------------Power_Init------------
+// Turn on automatic clock gating and choose the peripheral clocks
+// kept in sleep and deep sleep. Call after the drivers are set up,
+// the LCD panels included: the ports of their pins stay clocked in
+// sleep (ST7735_PanelPorts).
+// Input: none
+// Output: none
+void Power_Init(void){
+  SYSCTL_SCGCGPIO_R = GPIO_A|GPIO_F|ST7735_PanelPorts(); // U0Rx; SW1 edge interrupt; the LCD pins
+  SYSCTL_SCGCTIMER_R = TIMER_1;             // SW1 debounce
+  SYSCTL_SCGCSSI_R = 0;                     // set by Power_Sleep
+  SYSCTL_SCGCDMA_R = 0;
+  SYSCTL_SCGCUART_R = SYSCTL_RCGCUART_R&UART_0; // UART0 receive, if it is on
+  SYSCTL_DCGCGPIO_R = GPIO_A|GPIO_F;        // U0Rx (PA0) and SW1 wake deep sleep
+  SYSCTL_DCGCTIMER_R = 0;
+  SYSCTL_DCGCSSI_R = 0;
+  SYSCTL_DCGCDMA_R = 0;
+  SYSCTL_DCGCUART_R = SYSCTL_RCGCUART_R&UART_0; // runs from the PIOSC (UART_InitRx)
+  SYSCTL_DSLPCLKCFG_R = SYSCTL_DSLPCLKCFG_O_IO; // PIOSC, divide by 1
+  SYSCTL_RCC_R |= SYSCTL_RCC_ACG;           // sleep modes use SCGC and DCGC
+}
+
+//------------Power_Sleep------------
+// Sleep (WFI) until the next interrupt. The SSI modules and the uDMA
+// are gated unless an ST7735 uDMA stream is using them.
+// Input: none
+// Output: none
+void Power_Sleep(void){
+  uint32_t streaming = ST7735_StreamingSSI(); // the SSI handlers still have chunks to queue
+  SYSCTL_SCGCTIMER_R = ST7735_InitBusy() ? (TIMER_1|TIMER_2) : TIMER_1; // Timer2 paces an LCD init
+  SYSCTL_SCGCSSI_R = streaming;
+  SYSCTL_SCGCDMA_R = streaming ? UDMA : 0;
+  WaitForInterrupt();
+}
+
+//------------Power_DeepSleep------------
+// Deep sleep until the next interrupt that can reach the core (the
+// SW1 edge or a UART0 receive interrupt). The SysTick interrupt is
+// masked meanwhile, so scheduler ticks stop. The ST7735 must be idle
+// (ST7735_Sleep) and Switch_Busy() must be 0.
+// Input: none
+// Output: none
+void Power_DeepSleep(void){
+  NVIC_ST_CTRL_R &= ~NVIC_ST_CTRL_INTEN;    // SysTick would wake the core every tick
+  NVIC_SYS_CTRL_R |= NVIC_SYS_CTRL_SLEEPDEEP;
+  WaitForInterrupt();
+  NVIC_SYS_CTRL_R &= ~NVIC_SYS_CTRL_SLEEPDEEP;
+  NVIC_ST_CTRL_R |= NVIC_ST_CTRL_INTEN;
+}
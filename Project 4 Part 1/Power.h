@@ -0,0 +1,49 @@
+/*
+		File: Power.h
+		Group 17
+		Andrew Nguyen, Anton Tran, Tommy Troung, Abass Mir
+		Functionallity: Declares the low-power idle functions: sleep
+		with the unused peripheral clocks gated between scheduler
+		ticks, and deep sleep until SW1 while the display is off.
+*/ 
+
+// Power.h
+// Runs on TM4C123
+// With automatic clock gating on, the SCGC registers choose the
+// peripherals that keep their clock while the core sleeps and the
+// DCGC registers the ones that keep it in deep sleep. Only what can
+// wake the core, or is still working, stays clocked:
+//   sleep       Port F (SW1), Timer1 (debounce), and the SSI modules
+//               plus the uDMA only while pixel streams are still going out
+//               (Timer2 only while it paces ST7735_StartInitR)
+//   deep sleep  Port F, clocked from the PIOSC; the PLL stops
+// SysTick is in the core and keeps running in sleep.
+
+#ifndef _POWER_H_
+#define _POWER_H_
+#include <stdint.h>
+
+//------------Power_Init------------
+// Turn on automatic clock gating and choose the peripheral clocks
+// kept in sleep and deep sleep. Call after the drivers are set up.
+// Input: none
+// Output: none
+void Power_Init(void);
+
+//------------Power_Sleep------------
+// Sleep (WFI) until the next interrupt. The SSI modules and the uDMA
+// are gated unless an ST7735 uDMA stream is using them.
+// Input: none
+// Output: none
+void Power_Sleep(void);
+
+//------------Power_DeepSleep------------
+// Deep sleep until the next interrupt that can reach the core (the
+// SW1 edge or a UART0 receive interrupt). The SysTick interrupt is
+// masked meanwhile, so scheduler ticks stop. The ST7735 must be idle
+// (ST7735_Sleep) and Switch_Busy() must be 0.
+// Input: none
+// Output: none
+void Power_DeepSleep(void);
+
+#endif
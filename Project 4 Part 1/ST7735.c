@@ -99,17 +99,36 @@
 // Z (NC) analog input Z-axis from ADXL335 accelerometer
 // Backlight + - Light, backlight connected to +3.3 V
 
+// **********More panels (ST7735_PANELS in ST7735.h)*******************
+// Panel - SSI  - SCK - MOSI - TFT_CS - Data/Command - RESET
+//   0   - SSI0 - PA2 - PA5  - PA3    - PA6          - PA7
+//   1   - SSI2 - PB4 - PB7  - PB5    - PB2          - PB3
+//   2   - SSI3 - PD0 - PD3  - PD1    - PD2          - PD6
+//   3   - SSI1 - PF2 - PF1  - PF3    - PE1          - PE2
+// The LaunchPad joins PB6 to PD0 through R9 and PB7 to PD1 through
+// R10: remove both to use panel 2, or its SCK and TFT_CS fight panel
+// 1's MOSI (PB7) and PB6.  Panel 3 takes the PF1-PF3 pins of the RGB
+// LED, so a program driving it must not set those pins up as the LED
+// outputs (WeatherDisplay's PortF_Init does, it stops the build).
+
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include "ST7735.h"
+#include "Clock.h"
+#include "Format.h"
+#if ST7735_HOST
+#include "ST7735_Host.h"          // registers and SSI data of the panel model
+#define SSI_PUT(value) ST7735Host_Send(Panel - Panels, DCLevel != DC_COMMAND, (value), SSIFrame16)
+#else
 #include "tm4c123gh6pm.h"
+#define REG32(address) (*((volatile uint32_t *)(address))) // memory-mapped register
+#define SSI_PUT(value) (SSI_DR = (value))  // send one frame of the panel's SSI
+#endif
 
 // 16 rows (0 to 15) and 21 characters (0 to 20)
 // Requires (11 + size*size*6*8) bytes of transmission for each character
-uint32_t StX=0; // position along the horizonal axis 0 to 20
-uint32_t StY=0; // position along the vertical axis 0 to 15
-uint16_t StTextColor = ST7735_YELLOW;
 
 #define swap(a, b) { int16_t t = a; a = b; b = t; }
 #define ST7735_NOP     0x00
@@ -132,8 +151,12 @@ uint16_t StTextColor = ST7735_YELLOW;
 #define ST7735_RAMRD   0x2E
 
 #define ST7735_PTLAR   0x30
+#define ST7735_VSCRDEF 0x33
 #define ST7735_COLMOD  0x3A
 #define ST7735_MADCTL  0x36
+#define ST7735_VSCSAD  0x37
+#define ST7735_IDMOFF  0x38
+#define ST7735_IDMON   0x39
 
 #define ST7735_FRMCTR1 0xB1
 #define ST7735_FRMCTR2 0xB2
@@ -158,17 +181,15 @@ uint16_t StTextColor = ST7735_YELLOW;
 #define ST7735_GMCTRP1 0xE0
 #define ST7735_GMCTRN1 0xE1
 
-#define TFT_CS                  (*((volatile uint32_t *)0x40004020))
 #define TFT_CS_LOW              0           // CS normally controlled by hardware
-#define TFT_CS_HIGH             0x08
-#define DC                      (*((volatile uint32_t *)0x40004100))
+#define DC                      (*Panel->dc)
 #define DC_COMMAND              0
-#define DC_DATA                 0x40
-#define RESET                   (*((volatile uint32_t *)0x40004200))
+#define DC_DATA                 (Panel->dcData)
 #define RESET_LOW               0
-#define RESET_HIGH              0x80
+#define ST7735_SSI_MAXHZ        15000000    // 66 ns serial write cycle (datasheet)
 
 #define SSI_CR0_SCR_M           0x0000FF00  // SSI Serial Clock Rate
+#define SSI_CR0_SCR_S           8
 #define SSI_CR0_SPH             0x00000080  // SSI Serial Clock Phase
 #define SSI_CR0_SPO             0x00000040  // SSI Serial Clock Polarity
 #define SSI_CR0_FRF_M           0x00000030  // SSI Frame Format Select
@@ -210,8 +231,12 @@ uint16_t StTextColor = ST7735_YELLOW;
 #define ST7735_RAMRD   0x2E
 
 #define ST7735_PTLAR   0x30
+#define ST7735_VSCRDEF 0x33
 #define ST7735_COLMOD  0x3A
 #define ST7735_MADCTL  0x36
+#define ST7735_VSCSAD  0x37
+#define ST7735_IDMOFF  0x38
+#define ST7735_IDMON   0x39
 
 #define ST7735_FRMCTR1 0xB1
 #define ST7735_FRMCTR2 0xB2
@@ -497,11 +522,109 @@ static const uint8_t Font[] = {
 };
 
 
-static uint8_t ColStart, RowStart; // some displays need this changed
-static uint8_t Rotation;           // 0 to 3
-static enum initRFlags TabColor;
-static int16_t _width = ST7735_TFTWIDTH;   // this could probably be a constant, except it is used in Adafruit_GFX and depends on image rotation
-static int16_t _height = ST7735_TFTHEIGHT;
+// Panels
+// Each panel has its own SSI module, uDMA channel and interrupt,
+// wired as listed at the top of this file.  Everything the driver
+// keeps about one panel (its geometry, text cursor, SSI link state
+// and uDMA stream) is in a PanelState; the functions work on the
+// panel chosen with ST7735_SelectPanel() through Panel, and the old
+// global names below are aliases for its fields.  A uDMA stream on
+// one panel keeps going while the program draws on another, only
+// drawing on the same panel waits for it, so uDMA fills and copies
+// on several panels overlap.  The framebuffer, band renderer,
+// sprites and plot state are shared: they work on whichever panel
+// is selected when they send, so finish with one panel (for example
+// ST7735_Flush) before selecting the next.  The draw queue always
+// sends to panel 0.
+typedef struct {
+  uint32_t ssi;                 // SSI module base address
+  uint8_t ssiNum;               // n of SSIn, the bit in RCGCSSI
+  uint8_t dmaCh;                // uDMA channel of the SSI transmit FIFO
+  uint8_t dmaEnc;               // channel map encoding that selects it
+  uint8_t irq;                  // interrupt number of the SSI module
+  uint32_t port;                // GPIO port with SCK, MOSI and TFT_CS
+  uint8_t portNum;              // its bit in RCGCGPIO
+  uint8_t pins;                 // SCK|MOSI|TFT_CS pins of that port
+  uint8_t cs;                   // TFT_CS pin
+  uint32_t pctl;                // PCTL fields that select the SSI on pins
+  uint32_t ctlPort;             // GPIO port with Data/Command and RESET
+  uint8_t ctlPortNum;
+  uint8_t dcPin, resetPin;
+} PanelWiring;
+static const PanelWiring Wiring[4] = {
+  {0x40008000, 0, 11, 0,  7, 0x40004000, 0, 0x2C, 0x08, 0x00202200, 0x40004000, 0, 0x40, 0x80},
+  {0x4000A000, 2, 13, 2, 57, 0x40005000, 1, 0xB0, 0x20, 0x20220000, 0x40005000, 1, 0x04, 0x08},
+  {0x4000B000, 3, 15, 2, 58, 0x40007000, 3, 0x0B, 0x02, 0x00001011, 0x40007000, 3, 0x04, 0x40},
+  {0x40009000, 1, 25, 0, 34, 0x40025000, 5, 0x0E, 0x08, 0x00002220, 0x40024000, 4, 0x02, 0x04}
+};
+#define GPIO_REG(port, offset) REG32((port) + (offset))
+#define GPIO_DIR   0x400
+#define GPIO_AFSEL 0x420
+#define GPIO_DEN   0x51C
+#define GPIO_AMSEL 0x528
+#define GPIO_PCTL  0x52C
+#define GPIO_BITS(port, pins) (&REG32((port) + ((pins)<<2))) // data bits of pins
+
+typedef struct {
+#if !ST7735_FIXED
+  uint8_t colStart, rowStart;   // some displays need this changed
+  uint8_t rotation;             // 0 to 3
+  enum initRFlags tabColor;
+  int16_t width, height;        // these depend on image rotation
+#endif
+  uint32_t stX, stY;            // text cursor, see ST7735_SetCursor
+  uint16_t stTextColor;
+  uint32_t ssi;                 // SSI module base address (0 before init)
+  volatile uint32_t *dc;        // Data/Command pin
+  uint8_t dcData;               // value of *dc for data
+  uint8_t dcLevel;              // see setDC
+  uint8_t ssiFrame16;
+  uint8_t winX0, winX1, winY0, winY1, winValid; // see setAddrWindow
+  uint8_t dmaCh;
+  volatile uint8_t dmaBusy;     // see dmaStart
+  uint8_t dmaIncrement;
+  uint16_t dmaColor;
+  const uint16_t *dmaSource;
+  uint32_t dmaRemaining;
+  void (*dmaCallback)(void);
+  uint16_t lineBuffer[2][ST7735_TFTHEIGHT];
+  const uint8_t *initCmd;       // next command of ST7735_StartInitR
+  uint8_t initLeft;             // commands left in its list
+  uint8_t initList;             // list being sent, see initRList
+  uint8_t initOption;           // enum initRFlags of ST7735_StartInitR
+  volatile uint16_t initWait;   // ticks until the next step, 0 when not initializing
+} PanelState;
+static PanelState Panels[ST7735_PANELS];
+static PanelState *Panel = &Panels[0];  // panel being drawn on
+
+#if ST7735_FIXED                        // one panel type and rotation, see ST7735.h
+#define ColStart ((ST7735_FIXED_TAB == INITR_GREENTAB) ? 2 : 0)
+#define RowStart ((ST7735_FIXED_TAB == INITR_GREENTAB) ? 1 : 0)
+#define Rotation (ST7735_FIXED_ROTATION)
+#define TabColor ((enum initRFlags)ST7735_FIXED_TAB)
+#define _width   ST7735_WIDTH
+#define _height  ST7735_HEIGHT
+#else
+#define ColStart (Panel->colStart)
+#define RowStart (Panel->rowStart)
+#define Rotation (Panel->rotation)
+#define TabColor (Panel->tabColor)
+#define _width   (Panel->width)
+#define _height  (Panel->height)
+#endif
+#define StX         (Panel->stX)        // position along the horizonal axis 0 to 20
+#define StY         (Panel->stY)        // position along the vertical axis 0 to 15
+#define StTextColor (Panel->stTextColor)
+
+// Registers of the panel's SSI module
+#define SSI_REG(offset) REG32(Panel->ssi + (offset))
+#define SSI_CR0    SSI_REG(0x000)
+#define SSI_CR1    SSI_REG(0x004)
+#define SSI_DR     SSI_REG(0x008)
+#define SSI_SR     SSI_REG(0x00C)
+#define SSI_CPSR   SSI_REG(0x010)
+#define SSI_DMACTL SSI_REG(0x024)
+#define SSI_CC     SSI_REG(0xFC8)
 
 
 // The Data/Command pin must be valid when the eighth bit is
@@ -512,42 +635,525 @@ static int16_t _height = ST7735_TFTHEIGHT;
 // commands, and they are used when writing data.  This
 // ensures that the Data/Command pin status matches the byte
 // that is actually being transmitted.
-// The write command operation waits until all data has been
-// sent, configures the Data/Command pin for commands, sends
-// the command, and then waits for the transmission to
-// finish.
+// The Data/Command pin is only changed when the next byte needs
+// the other level, and only then does the SSI have to drain:
+// the write command operation waits for the transmitter to go
+// idle if data was being sent, configures the Data/Command pin
+// for commands and puts the command in the transmit FIFO.  It
+// does not wait for the command to go out; whatever comes next
+// (usually the command's parameters) waits only if it has to
+// change the pin back.
 // The write data operation waits until there is room in the
-// transmit FIFO, configures the Data/Command pin for data,
-// and then adds the data to the transmit FIFO.
+// transmit FIFO, configures the Data/Command pin for data (after
+// the same drain, if a command was last), and then adds the data
+// to the transmit FIFO.
 // NOTE: These functions will crash or stall indefinitely if
-// the SSI0 module is not initialized and enabled.
+// the panel's SSI module is not initialized and enabled.
+#define DMABusy     (Panel->dmaBusy)    // non-zero while the panel's uDMA channel owns its SSI
+#define SSIFrame16  (Panel->ssiFrame16) // non-zero while the SSI is in 16-bit frame mode
+#define DCLevel     (Panel->dcLevel)    // DC_COMMAND or DC_DATA as last set, 0xFF before the first byte
+#define WinX0       (Panel->winX0)      // column and row range last sent by setAddrWindow()
+#define WinX1       (Panel->winX1)
+#define WinY0       (Panel->winY0)
+#define WinY1       (Panel->winY1)
+#define WinValid    (Panel->winValid)   // WIN_COLS|WIN_ROWS once the LCD holds WinX and WinY
+#define WIN_COLS 0x01
+#define WIN_ROWS 0x02
+#if ST7735_STATS
+static uint32_t BytesSent;             // see ST7735_BytesSent()
+static ST7735_PrimStats Stats[ST7735_NUM_PRIMS]; // see ST7735_Stats()
+static volatile uint8_t StatPrim = ST7735_PRIM_OTHER; // primitive the traffic is charged to
+#define COUNT_BYTES(n)  (BytesSent += (n), Stats[StatPrim].dataBytes += (n))
+#define COUNT_CMD(n)    (BytesSent += (n), Stats[StatPrim].cmdBytes += (n))
+#define COUNT_PIXELS(n) (Stats[StatPrim].pixels += (n))
+// At the top of a primitive: count the call, charge what follows to it
+#define STAT_CALL(p)    (StatPrim = (p), Stats[p].calls++)
+// Around code that also runs inside other primitives (or in an
+// interrupt): charge it to p, then give the caller its primitive back
+#define STAT_ENTER(p)   uint8_t statCaller = StatPrim; STAT_CALL(p)
+#define STAT_LEAVE()    (StatPrim = statCaller)
+// At the top of an interrupt handler, ended by STAT_LEAVE(): what it
+// sends outside a primitive is charged to OTHER, not to the primitive
+// the main program was in
+#define STAT_INTERRUPT() uint8_t statCaller = StatPrim; StatPrim = ST7735_PRIM_OTHER
+#else
+#define COUNT_BYTES(n)
+#define COUNT_CMD(n)
+#define COUNT_PIXELS(n)
+#define STAT_CALL(p)
+#define STAT_ENTER(p)
+#define STAT_LEAVE()
+#define STAT_INTERRUPT()
+#endif
+void static ssiFrame8(void);
+// Set the Data/Command pin for the next byte, first letting the
+// bytes already queued go out at the old level
+void static setDC(uint8_t level) {
+  if(DCLevel == level) return;
+                                        // wait until SSI not busy/transmit FIFO empty
+  while((SSI_SR&SSI_SR_BSY)==SSI_SR_BSY){};
+  DC = level;
+  DCLevel = level;
+}
+
+
 void static writecommand(uint8_t c) {
-                                        // wait until SSI0 not busy/transmit FIFO empty
-  while((SSI0_SR_R&SSI_SR_BSY)==SSI_SR_BSY){};
-  DC = DC_COMMAND;
-  SSI0_DR_R = c;                        // data out
-                                        // wait until SSI0 not busy/transmit FIFO empty
-  while((SSI0_SR_R&SSI_SR_BSY)==SSI_SR_BSY){};
+  while(DMABusy){};                     // let a background pixel stream finish
+  if(SSIFrame16) ssiFrame8();           // commands are always 8-bit frames (drains the SSI)
+  setDC(DC_COMMAND);
+  while((SSI_SR&SSI_SR_TNF)==0){};      // wait until transmit FIFO not full
+  SSI_PUT(c);                           // data out
+  COUNT_CMD(1);
 }
 
 
 void static writedata(uint8_t c) {
-  while((SSI0_SR_R&SSI_SR_TNF)==0){};   // wait until transmit FIFO not full
-  DC = DC_DATA;
-  SSI0_DR_R = c;                        // data out
+  setDC(DC_DATA);
+  while((SSI_SR&SSI_SR_TNF)==0){};      // wait until transmit FIFO not full
+  SSI_PUT(c);                           // data out
+  COUNT_BYTES(1);
 }
-// Subroutine to wait 1 msec
-// Inputs: None
-// Outputs: None
-// Notes: ...
-void Delay1ms(uint32_t n){uint32_t volatile time;
+
+
+// Change the SSI frame size.  The frame size may only be
+// changed while the SSI is idle and disabled, so these wait
+// for the transmitter to drain first.  16-bit frames let one
+// FIFO entry (or one uDMA half-word) carry a whole RGB565
+// pixel, most significant byte first.
+#define SSI16_MIN_PIXELS 8              // smallest window sent in 16-bit frames, see setAddrWindow
+void static ssiFrame16(void) {
+  while((SSI_SR&SSI_SR_BSY)==SSI_SR_BSY){};
+  SSI_CR1 &= ~SSI_CR1_SSE;              // disable SSI
+  SSI_CR0 = (SSI_CR0&~SSI_CR0_DSS_M)+SSI_CR0_DSS_16;
+  SSI_CR1 |= SSI_CR1_SSE;               // enable SSI
+  SSIFrame16 = 1;
+}
+void static ssiFrame8(void) {
+  while((SSI_SR&SSI_SR_BSY)==SSI_SR_BSY){};
+  SSI_CR1 &= ~SSI_CR1_SSE;              // disable SSI
+  SSI_CR0 = (SSI_CR0&~SSI_CR0_DSS_M)+SSI_CR0_DSS_8;
+  SSI_CR1 |= SSI_CR1_SSE;               // enable SSI
+  SSIFrame16 = 0;
+}
+
+// Off-screen framebuffer
+// A full 128 by 160 frame at 16 bits per pixel needs 40 KB, more
+// than the 32 KB of SRAM, so the framebuffer holds one 8-bit
+// palette index per pixel (20 KB).  Palette entries are allocated
+// the first time each 16-bit color is drawn; the weather screens
+// and icons use fewer than 200 distinct colors.  Once all 256
+// entries are taken, the nearest existing color is substituted.
+// The palette is emptied whenever the whole screen is filled.
+// While the framebuffer is on, setAddrWindow() and writepixel()
+// draw into RAM instead of the LCD and record the window as a
+// dirty rectangle, so every drawing function works unchanged.
+// ST7735_Flush() sends only the merged dirty rectangles, so each
+// pixel crosses the SPI at most once per flush.
+#if ST7735_FRAMEBUFFER
+#define FB_SIZE       (ST7735_TFTWIDTH*ST7735_TFTHEIGHT)
+#define FB_HASHSIZE   512               // power of 2, larger than the palette
+#define FB_MAXDIRTY   8                 // dirty rectangles kept before forced merging
+typedef struct {
+  uint8_t x0, y0, x1, y1;               // inclusive corners
+} DirtyRect;
+static uint8_t FrameBuffer[FB_SIZE];    // palette index of each pixel, row-major
+static uint16_t Palette[256];           // 16-bit color of each palette index
+static uint16_t PaletteSize;            // number of palette entries in use
+static uint16_t PaletteHash[FB_HASHSIZE]; // palette index+1 by color hash, 0 if empty
+static uint16_t LastColor;              // one-entry lookup cache
+static uint8_t LastIndex;
+static uint8_t FBActive;                // non-zero while drawing goes to the framebuffer
+static uint8_t FBReady;                 // non-zero once the framebuffer has been cleared
+static uint8_t FBX0, FBY0, FBX1, FBY1;  // current window
+static uint8_t FBX, FBY;                // current write position in the window
+static DirtyRect Dirty[FB_MAXDIRTY];
+static uint8_t NumDirty;
+
+// Empty the palette.  Only valid when every pixel is about to be overwritten.
+void static fbPaletteReset(void) {
+  uint32_t i;
+  for(i=0; i<FB_HASHSIZE; i=i+1){
+    PaletteHash[i] = 0;
+  }
+  PaletteSize = 0;                      // also invalidates LastColor
+}
+
+// Find (or allocate) the palette index of a 16-bit color.
+uint8_t static fbIndex(uint16_t color) {
+  uint32_t h, i, d, bestd;
+  int32_t dr, dg, db;
+  if((color == LastColor) && PaletteSize) return LastIndex;
+  h = (((uint32_t)color*40503)>>8)&(FB_HASHSIZE-1);
+  while(PaletteHash[h]){                // linear probing
+    if(Palette[PaletteHash[h]-1] == color){
+      LastColor = color;
+      LastIndex = PaletteHash[h]-1;
+      return LastIndex;
+    }
+    h = (h+1)&(FB_HASHSIZE-1);
+  }
+  if(PaletteSize < 256){                // allocate a new entry
+    Palette[PaletteSize] = color;
+    PaletteSize = PaletteSize + 1;
+    PaletteHash[h] = PaletteSize;
+    LastColor = color;
+    LastIndex = PaletteSize-1;
+    return LastIndex;
+  }
+  bestd = 0xFFFFFFFF;                   // palette full, use the nearest color
+  for(i=0; i<256; i=i+1){
+    dr = (int32_t)(color>>11) - (int32_t)(Palette[i]>>11);
+    dg = (int32_t)((color>>5)&0x3F) - (int32_t)((Palette[i]>>5)&0x3F);
+    db = (int32_t)(color&0x1F) - (int32_t)(Palette[i]&0x1F);
+    d = 4*dr*dr + dg*dg + 4*db*db;      // red and blue have half the resolution of green
+    if(d < bestd){
+      bestd = d;
+      LastIndex = i;
+    }
+  }
+  LastColor = color;
+  return LastIndex;
+}
+
+// Add a rectangle to the dirty list, merging it with every
+// rectangle it overlaps or touches.  When the list is full the
+// pair whose union grows the least is merged.
+void static fbMarkDirty(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1) {
+  uint32_t i, best, area, bestArea;
+  uint8_t ux0, uy0, ux1, uy1;
+  i = 0;
+  while(i < NumDirty){
+    if((x0 <= Dirty[i].x1+1) && (Dirty[i].x0 <= x1+1) &&
+       (y0 <= Dirty[i].y1+1) && (Dirty[i].y0 <= y1+1)){
+      if(Dirty[i].x0 < x0) x0 = Dirty[i].x0;
+      if(Dirty[i].y0 < y0) y0 = Dirty[i].y0;
+      if(Dirty[i].x1 > x1) x1 = Dirty[i].x1;
+      if(Dirty[i].y1 > y1) y1 = Dirty[i].y1;
+      NumDirty = NumDirty - 1;          // remove it and rescan, the union may touch others
+      Dirty[i] = Dirty[NumDirty];
+      i = 0;
+    } else{
+      i = i + 1;
+    }
+  }
+  if(NumDirty < FB_MAXDIRTY){
+    Dirty[NumDirty].x0 = x0; Dirty[NumDirty].y0 = y0;
+    Dirty[NumDirty].x1 = x1; Dirty[NumDirty].y1 = y1;
+    NumDirty = NumDirty + 1;
+    return;
+  }
+  best = 0;
+  bestArea = 0xFFFFFFFF;
+  for(i=0; i<NumDirty; i=i+1){
+    ux0 = (Dirty[i].x0 < x0) ? Dirty[i].x0 : x0;
+    uy0 = (Dirty[i].y0 < y0) ? Dirty[i].y0 : y0;
+    ux1 = (Dirty[i].x1 > x1) ? Dirty[i].x1 : x1;
+    uy1 = (Dirty[i].y1 > y1) ? Dirty[i].y1 : y1;
+    area = (ux1-ux0+1)*(uy1-uy0+1) - (Dirty[i].x1-Dirty[i].x0+1)*(Dirty[i].y1-Dirty[i].y0+1);
+    if(area < bestArea){
+      bestArea = area;
+      best = i;
+    }
+  }
+  if(Dirty[best].x0 < x0) x0 = Dirty[best].x0;
+  if(Dirty[best].y0 < y0) y0 = Dirty[best].y0;
+  if(Dirty[best].x1 > x1) x1 = Dirty[best].x1;
+  if(Dirty[best].y1 > y1) y1 = Dirty[best].y1;
+  NumDirty = NumDirty - 1;
+  Dirty[best] = Dirty[NumDirty];
+  fbMarkDirty(x0, y0, x1, y1);
+}
+
+// Framebuffer version of setAddrWindow()
+void static fbWindow(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1) {
+  if(x1 >= _width)  x1 = _width-1;      // keep all writes inside FrameBuffer[]
+  if(y1 >= _height) y1 = _height-1;
+  if(x0 > x1) x0 = x1;
+  if(y0 > y1) y0 = y1;
+  FBX0 = FBX = x0;
+  FBY0 = FBY = y0;
+  FBX1 = x1;
+  FBY1 = y1;
+  fbMarkDirty(x0, y0, x1, y1);
+}
+
+// Step the write position like the LCD RAM pointer does
+void static fbAdvance(void) {
+  if(FBX < FBX1){
+    FBX = FBX + 1;
+  } else{
+    FBX = FBX0;
+    FBY = (FBY < FBY1) ? (FBY + 1) : FBY0;
+  }
+}
+
+// Framebuffer version of writepixel()
+void static fbPixel(uint16_t color) {
+  FrameBuffer[FBY*_width + FBX] = fbIndex(color);
+  fbAdvance();
+}
+
+// Write n copies of one color, a row segment at a time
+void static fbFill(uint16_t color, uint32_t n) {
+  uint32_t run;
+  uint8_t index;
+  if((FBX0 == 0) && (FBY0 == 0) && (FBX == 0) && (FBY == 0) &&
+     (FBX1 == _width-1) && (FBY1 == _height-1) && (n >= FB_SIZE)){
+    fbPaletteReset();                   // every pixel is replaced
+  }
+  index = fbIndex(color);
   while(n){
-    time = 72724*2/91;  // 1msec, tuned at 80 MHz
-    while(time){
-      time--;
+    run = FBX1 - FBX + 1;
+    if(run > n) run = n;
+    memset(&FrameBuffer[FBY*_width + FBX], index, run);
+    n = n - run;
+    FBX = FBX + run - 1;
+    fbAdvance();
+  }
+}
+#else
+
+// Band renderer
+// Without the framebuffer, ST7735_DrawList() renders a display list
+// ST7735_BAND_ROWS rows at a time: while the uDMA streams one band
+// buffer to the LCD, the list is played again into the other one
+// with setAddrWindow() and writepixel() clipped to that band's rows
+// (the same way the framebuffer captures them).  Every pixel is sent
+// once, top to bottom, through a single address window.
+#define BAND_PIXELS   (ST7735_BAND_ROWS*ST7735_TFTHEIGHT) // longest row in any rotation
+static uint16_t BandBuffer[2][BAND_PIXELS];
+static uint16_t *Band;                  // buffer being rendered
+static uint8_t BandActive;              // non-zero while drawing goes to Band
+static int16_t BandY0, BandY1;          // screen rows held by Band
+static uint8_t BWX0, BWY0, BWX1, BWY1;  // current window
+static uint8_t BWX, BWY;                // current write position in the window
+
+// Band version of setAddrWindow()
+void static bandWindow(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1) {
+  BWX0 = BWX = x0;
+  BWY0 = BWY = y0;
+  BWX1 = x1;
+  BWY1 = y1;
+}
+
+// Band version of writepixel() and dmaStart(): n pixels from source,
+// or n copies of color, a row segment at a time; rows outside the
+// band are skipped
+void static bandWrite(const uint16_t *source, uint16_t color, uint8_t increment, uint32_t n) {
+  uint32_t run, i;
+  uint16_t *dst;
+  while(n){
+    run = BWX1 - BWX + 1;
+    if(run > n) run = n;
+    if((BWY >= BandY0) && (BWY <= BandY1)){
+      dst = &Band[(BWY - BandY0)*_width + BWX];
+      if(increment){
+        for(i=0; i<run; i=i+1) dst[i] = source[i];
+      } else{
+        for(i=0; i<run; i=i+1) dst[i] = color;
+      }
+    }
+    if(increment) source = source + run;
+    n = n - run;
+    if((BWX + run) > BWX1){
+      BWX = BWX0;
+      BWY = (BWY < BWY1) ? (BWY + 1) : BWY0;
+    } else{
+      BWX = BWX + run;
+    }
+  }
+}
+#endif
+
+
+// uDMA transfer engine for pixel streams
+// Each panel's SSI transmit FIFO has its own uDMA channel (channel 11
+// for SSI0, CHMAP1 CH11SEL = 0; the others are in Wiring).
+// A transfer moves 16-bit pixels from either a RAM/ROM buffer or
+// a single fixed color into the SSI data register.  One uDMA transfer
+// is limited to 1024 items, so longer streams are split into chunks
+// and the SSI handler re-arms the channel until the stream is done.
+// On the TM4C123 the completion interrupt of a peripheral uDMA
+// channel is signaled on that peripheral's vector, so SSI0_Handler
+// (not uDMA_Handler) sees it for panel 0.
+// writecommand() waits for DMABusy to clear, so every other driver
+// function automatically queues behind a background transfer.
+#define DMA_BIT           (1u<<Panel->dmaCh) // channel bit in the uDMA registers
+#define DMA_PRI           (Panel->dmaCh*4) // word offset of the channel's primary control structure
+#define DMA_MAXXFER       1024          // maximum items per uDMA transfer
+#define DMA_MIN_PIXELS    32            // FillRect uses uDMA at or above this many pixels
+#if !ST7735_HOST                        // no uDMA in the panel model
+static uint32_t DMAControlTable[256] __attribute__((aligned(1024)));
+#endif
+#define DMASource     (Panel->dmaSource)    // next pixel to send (buffer transfers)
+#define DMARemaining  (Panel->dmaRemaining) // pixels not yet handed to the uDMA
+#define DMAIncrement  (Panel->dmaIncrement) // 1 for buffer transfers, 0 for fill transfers
+#define DMAColor      (Panel->dmaColor)     // source of fill transfers
+#define DMACallback   (Panel->dmaCallback)  // called from the SSI handler on completion
+static volatile uint8_t QueueRunning;  // the draw queue owns SSI0 until it is empty
+void static queueStep(void);
+void static queueResume(void);
+// Ping-pong row buffers for uDMA streams (ST7735_Flush, ST7735_DrawText,
+// ST7735_DrawScreen).  Each of those starts with setAddrWindow(), which
+// waits for the previous stream, so they can share one pair per panel.
+#define LineBuffer    (Panel->lineBuffer)   // longest row in any rotation
+
+// Wait until the uDMA is done with the other line buffer.  While a
+// band is being rendered the line is copied at once, and the stream
+// still running is the previous band, so there is nothing to wait for
+// (ST7735_DrawList waits for any other stream before the first band).
+void static lineBufferWait(void) {
+#if !ST7735_FRAMEBUFFER
+  if(BandActive) return;
+#endif
+  while(DMABusy){};
+}
+
+#if !ST7735_HOST
+// Arm the panel's channel for the next chunk of the current stream.
+void static dmaStartChunk(void) {
+  uint32_t count = DMARemaining;
+  uint32_t ctl;
+  if(count > DMA_MAXXFER) count = DMA_MAXXFER;
+  if(DMAIncrement){
+    DMAControlTable[DMA_PRI] = (uint32_t)(DMASource + count - 1); // source end pointer
+    ctl = UDMA_CHCTL_SRCINC_16;
+    DMASource = DMASource + count;
+  } else{
+    DMAControlTable[DMA_PRI] = (uint32_t)&DMAColor;
+    ctl = UDMA_CHCTL_SRCINC_NONE;
+  }
+  DMAControlTable[DMA_PRI+1] = (uint32_t)&SSI_DR;  // destination end pointer
+  DMAControlTable[DMA_PRI+2] = ctl | UDMA_CHCTL_DSTINC_NONE |
+                               UDMA_CHCTL_DSTSIZE_16 | UDMA_CHCTL_SRCSIZE_16 |
+                               UDMA_CHCTL_ARBSIZE_4 | ((count-1)<<4) |
+                               UDMA_CHCTL_XFERMODE_BASIC;
+  DMARemaining = DMARemaining - count;
+  UDMA_ENASET_R = DMA_BIT;              // the channel starts on the next SSI TX request
+}
+#endif
+
+// Start a background stream of n pixels into the current
+// address window.  The caller has already sent RAMWR.
+void static dmaStart(const uint16_t *source, uint16_t color, uint8_t increment, uint32_t n) {
+  if(n == 0) return;
+  COUNT_PIXELS(n);
+#if !ST7735_FRAMEBUFFER
+  if(BandActive){
+    bandWrite(source, color, increment, n);
+    return;
+  }
+#endif
+#if ST7735_FRAMEBUFFER
+  if(FBActive){                         // framebuffer copies are synchronous
+    if(increment){
+      const uint16_t *pt = source;
+      uint32_t count = n;
+      while(count){
+        fbPixel(*pt);
+        pt++;
+        count--;
+      }
+    } else{
+      fbFill(color, n);
+    }
+    return;
+  }
+#endif
+  if(!SSIFrame16) ssiFrame16();
+  setDC(DC_DATA);
+  COUNT_BYTES(2*n);
+  DMASource = source;
+  DMAColor = color;
+  DMAIncrement = increment;
+  DMARemaining = n;
+  DMABusy = 1;
+#if ST7735_HOST
+  // The panel model takes the whole stream at once, and it completes
+  // as in panelHandler(); ST7735_Enqueue runs the draw queue itself
+  while(DMARemaining){
+    SSI_PUT(DMAIncrement ? *DMASource++ : DMAColor);
+    DMARemaining--;
+  }
+  DMABusy = 0;
+  if(DMACallback){
+    STAT_INTERRUPT();
+    (*DMACallback)();
+    STAT_LEAVE();
+  }
+#else
+  dmaStartChunk();
+#endif
+}
+
+#if ST7735_HOST
+void static dmaInit(const PanelWiring *w) {
+  (void)w;                              // no uDMA and no interrupts in the panel model
+}
+#else
+// Enable the uDMA controller and route the panel's channel to its
+// SSI transmit FIFO.
+void static dmaInit(const PanelWiring *w) {
+  volatile uint32_t *chmap = (volatile uint32_t *)&UDMA_CHMAP0_R + (w->dmaCh>>3);
+  uint32_t shift = 4*(w->dmaCh&7);      // CHnSEL field of the channel
+  SYSCTL_RCGCDMA_R |= SYSCTL_RCGCDMA_R0; // activate uDMA
+  while((SYSCTL_PRDMA_R&SYSCTL_PRDMA_R0)==0){};
+  UDMA_CFG_R = UDMA_CFG_MASTEN;         // enable uDMA controller
+  UDMA_CTLBASE_R = (uint32_t)DMAControlTable;
+  *chmap = (*chmap&~(0xFu<<shift))|((uint32_t)w->dmaEnc<<shift); // channel = SSIn TX
+  UDMA_PRIOCLR_R = DMA_BIT;             // default priority
+  UDMA_ALTCLR_R = DMA_BIT;              // use primary control structure
+  UDMA_USEBURSTCLR_R = DMA_BIT;         // respond to single and burst requests
+  UDMA_REQMASKCLR_R = DMA_BIT;          // allow the SSI to request transfers
+  SSI_DMACTL |= SSI_DMACTL_TXDMAE;      // SSI TX FIFO drives uDMA requests
+  ((volatile uint8_t *)&NVIC_PRI0_R)[w->irq] = 0x40; // priority 2 (SSI0 is IRQ 7)
+  ((volatile uint32_t *)&NVIC_EN0_R)[w->irq>>5] = 1u<<(w->irq&31); // enable the SSI interrupt in NVIC
+}
+
+// Executed on the completion of panel p's uDMA channel.  The main
+// program may be drawing on another panel, so Panel is put back.
+void static panelHandler(PanelState *p) {
+  PanelState *caller = Panel;
+  STAT_INTERRUPT();                     // the callback may draw
+  Panel = p;
+  if(UDMA_CHIS_R&DMA_BIT){
+    UDMA_CHIS_R = DMA_BIT;              // acknowledge
+    if(DMARemaining){
+      dmaStartChunk();
+    } else{
+      DMABusy = 0;
+      if(QueueRunning && (p == &Panels[0])) queueStep(); // next row or command of the draw queue
+      if(!DMABusy && DMACallback) (*DMACallback)();
     }
-    n--;
   }
+  STAT_LEAVE();
+  Panel = caller;
+}
+void SSI0_Handler(void) {
+  panelHandler(&Panels[0]);
+}
+#if ST7735_PANELS > 1
+void SSI2_Handler(void) {
+  panelHandler(&Panels[1]);
+}
+#endif
+#if ST7735_PANELS > 2
+void SSI3_Handler(void) {
+  panelHandler(&Panels[2]);
+}
+#endif
+#if ST7735_PANELS > 3
+void SSI1_Handler(void) {
+  panelHandler(&Panels[3]);
+}
+#endif
+#endif // ST7735_HOST
+// Subroutine to wait 1 msec
+// Inputs: None
+// Outputs: None
+// Notes: scaled to the bus clock recorded by Clock_Init()
+void Delay1ms(uint32_t n){
+  Clock_Delay1ms(n);
 }
 
 // Rather than a bazillion writecommand() and writedata() calls, screen
@@ -696,6 +1302,7 @@ void static commandList(const uint8_t *addr) {
   uint8_t numCommands, numArgs;
   uint16_t ms;
 
+  WinValid = 0;                          // the list may set the window (and SWRESET clears it)
   numCommands = *(addr++);               // Number of commands to follow
   while(numCommands--) {                 // For each command...
     writecommand(*(addr++));             //   Read, issue command
@@ -707,6 +1314,7 @@ void static commandList(const uint8_t *addr) {
     }
 
     if(ms) {
+      while((SSI_SR&SSI_SR_BSY)==SSI_SR_BSY){}; // the delay starts once the command is out
       ms = *(addr++);             // Read post-command delay time (ms)
       if(ms == 255) ms = 500;     // If 255, delay for 500 ms
       Delay1ms(ms);
@@ -715,60 +1323,129 @@ void static commandList(const uint8_t *addr) {
 }
 
 
-// Initialization code common to both 'B' and 'R' type displays
-void static commonInit(const uint8_t *cmdList) {
-  volatile uint32_t delay;
-  ColStart  = RowStart = 0; // May be overridden in init func
+// PCTL fields (4 bits per pin) of the given pins
+uint32_t static pctlMask(uint8_t pins) {
+  uint32_t mask = 0;
+  for(int i = 0; i < 8; i++){
+    if(pins&(1<<i)) mask |= 0xFu<<(4*i);
+  }
+  return mask;
+}
 
-  SYSCTL_RCGCSSI_R |= 0x01;  // activate SSI0
-  SYSCTL_RCGCGPIO_R |= 0x01; // activate port A
-  while((SYSCTL_PRGPIO_R&0x01)==0){}; // allow time for clock to start
+// Reset timing from the datasheet: the RESET pulse must be at least
+// 10 us long, and the panel takes 120 ms after it to come up.
+#define ST7735_RESET_US 20
+#define ST7735_RESET_MS 120
+
+// Set up the selected panel's pins, SSI module and uDMA channel and
+// pulse its RESET; the caller waits ST7735_RESET_MS before commands.
+void static panelSetup(void) {
+  const PanelWiring *w = &Wiring[Panel - Panels];
+  uint8_t gpio = w->dcPin|w->resetPin;
+  volatile uint32_t *reset = GPIO_BITS(w->ctlPort, w->resetPin);
+  uint32_t cpsdvsr, scr;
+#if !ST7735_FIXED
+  ColStart  = RowStart = 0; // May be overridden in init func
+  Rotation = 0;
+  _width = ST7735_TFTWIDTH;
+  _height = ST7735_TFTHEIGHT;
+#endif
+  Panel->ssi = w->ssi;
+  Panel->dc = GPIO_BITS(w->ctlPort, w->dcPin);
+  Panel->dcData = w->dcPin;
+  Panel->dmaCh = w->dmaCh;
+  DCLevel = 0xFF;
+
+  SYSCTL_RCGCSSI_R |= 1<<w->ssiNum;  // activate the SSI module
+  SYSCTL_RCGCGPIO_R |= (1<<w->portNum)|(1<<w->ctlPortNum); // activate its ports
+  while((SYSCTL_PRGPIO_R&(1<<w->portNum))==0){}; // allow time for clock to start
+  while((SYSCTL_PRGPIO_R&(1<<w->ctlPortNum))==0){};
 
   // toggle RST low to reset; CS low so it'll listen to us
-  // SSI0Fss is temporarily used as GPIO
-  GPIO_PORTA_DIR_R |= 0xC8;             // make PA3,6,7 out
-  GPIO_PORTA_AFSEL_R &= ~0xC8;          // disable alt funct on PA3,6,7
-  GPIO_PORTA_DEN_R |= 0xC8;             // enable digital I/O on PA3,6,7
-                                        // configure PA3,6,7 as GPIO
-  GPIO_PORTA_PCTL_R = (GPIO_PORTA_PCTL_R&0x00FF0FFF)+0x00000000;
-  GPIO_PORTA_AMSEL_R &= ~0xC8;          // disable analog functionality on PA3,6,7
-  TFT_CS = TFT_CS_LOW;
-  RESET = RESET_HIGH;
-  Delay1ms(500);
-  RESET = RESET_LOW;
-  Delay1ms(500);
-  RESET = RESET_HIGH;
-  Delay1ms(500);
-
-  // initialize SSI0
-  GPIO_PORTA_AFSEL_R |= 0x2C;           // enable alt funct on PA2,3,5
-  GPIO_PORTA_DEN_R |= 0x2C;             // enable digital I/O on PA2,3,5
-                                        // configure PA2,3,5 as SSI
-  GPIO_PORTA_PCTL_R = (GPIO_PORTA_PCTL_R&0xFF0F00FF)+0x00202200;
-  GPIO_PORTA_AMSEL_R &= ~0x2C;          // disable analog functionality on PA2,3,5
-  SSI0_CR1_R &= ~SSI_CR1_SSE;           // disable SSI
-  SSI0_CR1_R &= ~SSI_CR1_MS;            // master mode
+  // the SSI's Fss is temporarily used as GPIO (PA3,6,7 for panel 0)
+  GPIO_REG(w->port, GPIO_DIR) |= w->cs;   // make Fss out
+  GPIO_REG(w->port, GPIO_AFSEL) &= ~w->cs; // disable alt funct on Fss
+  GPIO_REG(w->port, GPIO_DEN) |= w->cs;   // enable digital I/O on Fss
+  GPIO_REG(w->port, GPIO_PCTL) &= ~pctlMask(w->cs); // configure Fss as GPIO
+  GPIO_REG(w->port, GPIO_AMSEL) &= ~w->cs; // disable analog functionality on Fss
+  GPIO_REG(w->ctlPort, GPIO_DIR) |= gpio;  // same for Data/Command and RESET
+  GPIO_REG(w->ctlPort, GPIO_AFSEL) &= ~gpio;
+  GPIO_REG(w->ctlPort, GPIO_DEN) |= gpio;
+  GPIO_REG(w->ctlPort, GPIO_PCTL) &= ~pctlMask(gpio);
+  GPIO_REG(w->ctlPort, GPIO_AMSEL) &= ~gpio;
+  *GPIO_BITS(w->port, w->cs) = TFT_CS_LOW;
+  *reset = RESET_LOW;
+  Clock_Delay1us(ST7735_RESET_US);
+  *reset = w->resetPin;
+
+  // initialize the SSI
+  GPIO_REG(w->port, GPIO_AFSEL) |= w->pins; // enable alt funct on Clk, Fss and Tx
+  GPIO_REG(w->port, GPIO_DEN) |= w->pins;   // enable digital I/O on them
+                                        // configure them as SSI (PA2,3,5 for panel 0)
+  GPIO_REG(w->port, GPIO_PCTL) = (GPIO_REG(w->port, GPIO_PCTL)&~pctlMask(w->pins))+w->pctl;
+  GPIO_REG(w->port, GPIO_AMSEL) &= ~w->pins; // disable analog functionality on them
+  SSI_CR1 &= ~SSI_CR1_SSE;              // disable SSI
+  SSI_CR1 &= ~SSI_CR1_MS;               // master mode
                                         // configure for system clock/PLL baud clock source
-  SSI0_CC_R = (SSI0_CC_R&~SSI_CC_CS_M)+SSI_CC_CS_SYSPLL;
-//                                        // clock divider for 3.125 MHz SSIClk (50 MHz PIOSC/16)
-//  SSI0_CPSR_R = (SSI0_CPSR_R&~SSI_CPSR_CPSDVSR_M)+16;
-                                        // clock divider for 8 MHz SSIClk (80 MHz PLL/24)
+  SSI_CC = (SSI_CC&~SSI_CC_CS_M)+SSI_CC_CS_SYSPLL;
+                                        // fastest SSIClk the ST7735 takes on write
                                         // SysClk/(CPSDVSR*(1+SCR))
-                                        // 80/(10*(1+0)) = 8 MHz (slower than 4 MHz)
-  SSI0_CPSR_R = (SSI0_CPSR_R&~SSI_CPSR_CPSDVSR_M)+10; // must be even number
-  SSI0_CR0_R &= ~(SSI_CR0_SCR_M |       // SCR = 0 (8 Mbps data rate)
-                  SSI_CR0_SPH |         // SPH = 0
-                  SSI_CR0_SPO);         // SPO = 0
+                                        // 80/(2*(1+2)) = 13.3 MHz, 16/(2*(1+0)) = 8 MHz
+  Clock_SSIDivider(ST7735_SSI_MAXHZ, &cpsdvsr, &scr);
+  SSI_CPSR = (SSI_CPSR&~SSI_CPSR_CPSDVSR_M)+cpsdvsr; // must be even number
+  SSI_CR0 &= ~(SSI_CR0_SCR_M |          // SCR from Clock_SSIDivider
+               SSI_CR0_SPH |            // SPH = 0
+               SSI_CR0_SPO);            // SPO = 0
+  SSI_CR0 |= scr<<SSI_CR0_SCR_S;
                                         // FRF = Freescale format
-  SSI0_CR0_R = (SSI0_CR0_R&~SSI_CR0_FRF_M)+SSI_CR0_FRF_MOTO;
+  SSI_CR0 = (SSI_CR0&~SSI_CR0_FRF_M)+SSI_CR0_FRF_MOTO;
                                         // DSS = 8-bit data
-  SSI0_CR0_R = (SSI0_CR0_R&~SSI_CR0_DSS_M)+SSI_CR0_DSS_8;
-  SSI0_CR1_R |= SSI_CR1_SSE;            // enable SSI
+  SSI_CR0 = (SSI_CR0&~SSI_CR0_DSS_M)+SSI_CR0_DSS_8;
+  SSI_CR1 |= SSI_CR1_SSE;               // enable SSI
+  SSIFrame16 = 0;
+  dmaInit(w);
+}
 
+
+// Initialization code common to both 'B' and 'R' type displays,
+// for the selected panel
+void static commonInit(const uint8_t *cmdList) {
+  panelSetup();
+  Delay1ms(ST7735_RESET_MS);
   if(cmdList) commandList(cmdList);
 }
 
 
+void static sendMADCTL(void);
+// Last steps of an ST7735R init, after the command lists: only
+// commands to the panel and its settings, so the background init can
+// run them from Timer2A_Handler
+void static initFinish(uint8_t option) {
+#if !ST7735_FIXED
+  if(option == INITR_GREENTAB) {
+    ColStart = 2;
+    RowStart = 1;
+  }
+#endif
+  // if black, change MADCTL color filter
+  if (option == INITR_BLACKTAB) {
+    writecommand(ST7735_MADCTL);
+    writedata(0xC0);
+  }
+#if ST7735_FIXED
+  if(Rotation) sendMADCTL();            // the lists leave rotation 0
+#else
+  TabColor = (enum initRFlags)option;
+#endif
+}
+
+// Text cursor and color of a new panel, from the main program
+void static initText(void) {
+  ST7735_SetCursor(0,0);
+  StTextColor = ST7735_YELLOW;
+}
+
+
 //------------ST7735_InitB------------
 // Initialization for ST7735B screens.
 // Input: none
@@ -786,62 +1463,318 @@ void ST7735_InitB(void) {
 // Input: option one of the enumerated options depending on tabs
 // Output: none
 void ST7735_InitR(enum initRFlags option) {
+#if ST7735_FIXED
+  option = TabColor;                    // built for one panel
+#endif
   commonInit(Rcmd1);
   if(option == INITR_GREENTAB) {
-    commandList(Rcmd2green);
-    ColStart = 2;
-    RowStart = 1;
+    commandList(Rcmd2green);            // initFinish sets the panel offsets
   } else {
     // colstart, rowstart left at default '0' values
     commandList(Rcmd2red);
   }
   commandList(Rcmd3);
+  initFinish(option);
+  initText();
+  ST7735_FillScreen(0);                 // set screen to black
+}
 
-  // if black, change MADCTL color filter
-  if (option == INITR_BLACKTAB) {
-    writecommand(ST7735_MADCTL);
-    writedata(0xC0);
+
+// Background initialization
+// ST7735_StartInitR() sets up the SSI, pulses RESET and returns; the
+// command lists are then sent from Timer2A_Handler, which ticks every
+// millisecond while a panel is initializing and waits out each delay
+// instead of busy-waiting.  The waits are the datasheet minimums
+// (initDelay), not the longer ones in the lists, and the software
+// reset is left out because the hardware reset has just been done,
+// so the panel is up about 140 ms after the call.  DMABusy is held
+// set meanwhile, so drawing on the panel waits in writecommand() and
+// setAddrWindow() until the init is done, and the program can set up
+// its other peripherals in the meantime.  Only commands to the panel
+// are sent from the interrupt; the screen is not cleared (the
+// program's first frame is expected to cover it, ST7735_FillScreen
+// right after ST7735_StartInitR waits for the init otherwise).
+#define INIT_TIMER_IRQ 23               // Timer2A
+
+// Command lists of an ST7735R init, in order; 0 after the last
+static const uint8_t *initRList(uint8_t option, uint8_t i) {
+  switch(i){
+    case 0: return Rcmd1;
+    case 1: return (option == INITR_GREENTAB) ? Rcmd2green : Rcmd2red;
+    case 2: return Rcmd3;
   }
-  TabColor = option;
-  ST7735_SetCursor(0,0);
-  StTextColor = ST7735_YELLOW;
-  ST7735_FillScreen(0);                 // set screen to black
+  return 0;
+}
+
+// Wait in ms after a command of the background init: the datasheet
+// minimum for the commands the lists give long delays
+uint16_t static initDelay(uint8_t cmd, uint8_t ms) {
+  switch(cmd){
+    case ST7735_SLPOUT: return 5;       // supplies and oscillator settle (500 ms in Rcmd1)
+    case ST7735_NORON:  return 0;
+    case ST7735_DISPON: return 0;       // (100 ms in Rcmd3)
+  }
+  return (ms == 255) ? 500 : ms;
+}
+
+// Send the background init of the selected panel up to its next wait.
+// Runs in Timer2A_Handler.
+void static initStep(void) {
+  uint8_t cmd, numArgs;
+  uint16_t ms;
+  while(1){
+    if(Panel->initLeft == 0){           // start the next list
+      const uint8_t *list = initRList(Panel->initOption, Panel->initList);
+      if(list == 0){
+        initFinish(Panel->initOption);
+        Panel->initWait = 0;            // ready: drawing on the panel goes ahead
+        return;
+      }
+      Panel->initList = Panel->initList + 1;
+      Panel->initLeft = list[0];
+      Panel->initCmd = list + 1;
+    }
+    cmd = *(Panel->initCmd++);
+    numArgs = *(Panel->initCmd++);
+    ms = numArgs & DELAY;
+    numArgs &= ~DELAY;
+    Panel->initLeft = Panel->initLeft - 1;
+    if(cmd == ST7735_SWRESET){          // already reset by the RESET pin
+      Panel->initCmd = Panel->initCmd + numArgs + (ms ? 1 : 0);
+      continue;
+    }
+    writecommand(cmd);
+    while(numArgs--){
+      writedata(*(Panel->initCmd++));
+    }
+    if(ms){
+      ms = initDelay(cmd, *(Panel->initCmd++));
+      if(ms){
+        while((SSI_SR&SSI_SR_BSY)==SSI_SR_BSY){}; // the delay starts once the command is out
+        Panel->initWait = ms + 1;       // the next tick may be less than 1 ms away
+        return;
+      }
+    }
+  }
+}
+
+// Executed every millisecond while a panel is initializing
+void Timer2A_Handler(void) {
+  PanelState *caller = Panel;           // the main program may be drawing on another panel
+  uint32_t pending = 0;
+  STAT_INTERRUPT();                     // the init commands are not the main program's
+  TIMER2_ICR_R = TIMER_ICR_TATOCINT;    // acknowledge
+  for(int n = 0; n < ST7735_PANELS; n++){
+    if(Panels[n].initWait == 0) continue;
+    Panel = &Panels[n];
+    Panel->initWait = Panel->initWait - 1;
+    if(Panel->initWait == 0){
+      DMABusy = 0;                      // let writecommand() through
+      Panel->initWait = 1;              // still initializing
+      initStep();
+      if(Panel->initWait){
+        DMABusy = 1;                    // hold the main program back until the next step
+      } else if(QueueRunning && (n == 0)){
+        queueResume();                  // operations queued during the init waited for it
+      }
+    }
+    if(Panel->initWait) pending = 1;
+  }
+  if(!pending) TIMER2_CTL_R = 0;        // stop ticking
+  STAT_LEAVE();
+  Panel = caller;
+}
+
+
+//------------ST7735_StartInitR------------
+// Start initializing the selected ST7735R panel (green or red tabs)
+// in the background.  The function returns after the RESET pulse;
+// the command lists follow from Timer2A_Handler, and the panel is
+// ready about 140 ms later, showing whatever its RAM held (it is not
+// cleared, see Background initialization).  Until then drawing on the panel waits,
+// so the program may go on setting up its other peripherals and draw
+// its first frame as soon as it is ready.
+// Input: option one of the enumerated options depending on tabs
+// Output: none
+void ST7735_StartInitR(enum initRFlags option) {
+#if ST7735_FIXED
+  option = TabColor;                    // built for one panel
+#endif
+  panelSetup();
+  initText();
+  WinValid = 0;
+  Panel->initOption = option;
+  Panel->initList = 0;
+  Panel->initLeft = 0;
+  Panel->initWait = ST7735_RESET_MS + 1;
+  DMABusy = 1;                          // holds back drawing on the panel until the init is done
+  SYSCTL_RCGCTIMER_R |= 0x04;           // activate clock for Timer2
+  while((SYSCTL_PRTIMER_R&0x04) == 0){};
+  if((TIMER2_CTL_R&TIMER_CTL_TAEN) == 0){ // else it is already ticking for another panel
+    TIMER2_CTL_R = 0;                   // disable Timer2A during setup
+    TIMER2_CFG_R = 0;                   // 32-bit mode
+    TIMER2_TAMR_R = 0x02;               // periodic, down-count
+    TIMER2_TAILR_R = Clock_BusHz()/1000 - 1; // 1 ms
+    TIMER2_TAPR_R = 0;
+    TIMER2_ICR_R = TIMER_ICR_TATOCINT;  // clear timeout flag
+    TIMER2_IMR_R = TIMER_IMR_TATOIM;    // arm timeout interrupt
+    NVIC_PRI5_R = (NVIC_PRI5_R&0x00FFFFFF)|0x40000000; // Timer2A is IRQ 23, priority 2
+    NVIC_EN0_R = 1<<INIT_TIMER_IRQ;
+    TIMER2_CTL_R = TIMER_CTL_TAEN;
+  }
+}
+
+
+//------------ST7735_InitBusy------------
+// Check whether a background initialization (ST7735_StartInitR) is
+// still in progress on any panel.
+// Input: none
+// Output: 1 while Timer2A is still sending init commands, 0 if not
+int ST7735_InitBusy(void) {
+  for(int n = 0; n < ST7735_PANELS; n++){
+    if(Panels[n].initWait) return 1;
+  }
+  return 0;
 }
 
 
 // Set the region of the screen RAM to be modified
 // Pixel colors are sent left to right, top to bottom
 // (same as Font table is encoded; different from regular bitmap)
-// Requires 11 bytes of transmission
+// After RAMWR a window of SSI16_MIN_PIXELS or more puts the SSI in
+// 16-bit pixel frames, which pays for the drain of the switch (the
+// next writecommand() drains again to go back to 8-bit frames);
+// smaller windows (a pixel, short lines) keep 8-bit frames, so they
+// drain the SSI only when the Data/Command level changes.
+// The LCD keeps the column and row ranges between windows, so
+// CASET or RASET is only sent when its range differs from the
+// last one sent; RAMWR always is, it restarts the write pointer.
+// Requires 1 to 11 bytes of transmission
 void static setAddrWindow(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1) {
+#if ST7735_FRAMEBUFFER
+  if(FBActive){
+    fbWindow(x0, y0, x1, y1);
+    return;
+  }
+#else
+  if(BandActive){
+    bandWindow(x0, y0, x1, y1);
+    return;
+  }
+#endif
+  while(DMABusy){};                     // the draw queue may change the window until it is done
+  STAT_ENTER(ST7735_PRIM_WINDOW);
+  x0 = x0 + ColStart;
+  x1 = x1 + ColStart;
+  y0 = y0 + RowStart;
+  y1 = y1 + RowStart;
+
+  if(!(WinValid&WIN_COLS) || (x0 != WinX0) || (x1 != WinX1)){
+    writecommand(ST7735_CASET); // Column addr set
+    writedata(0x00);
+    writedata(x0);              // XSTART
+    writedata(0x00);
+    writedata(x1);              // XEND
+    WinX0 = x0;
+    WinX1 = x1;
+    WinValid |= WIN_COLS;
+  }
 
-  writecommand(ST7735_CASET); // Column addr set
-  writedata(0x00);
-  writedata(x0+ColStart);     // XSTART
-  writedata(0x00);
-  writedata(x1+ColStart);     // XEND
-
-  writecommand(ST7735_RASET); // Row addr set
-  writedata(0x00);
-  writedata(y0+RowStart);     // YSTART
-  writedata(0x00);
-  writedata(y1+RowStart);     // YEND
+  if(!(WinValid&WIN_ROWS) || (y0 != WinY0) || (y1 != WinY1)){
+    writecommand(ST7735_RASET); // Row addr set
+    writedata(0x00);
+    writedata(y0);              // YSTART
+    writedata(0x00);
+    writedata(y1);              // YEND
+    WinY0 = y0;
+    WinY1 = y1;
+    WinValid |= WIN_ROWS;
+  }
 
   writecommand(ST7735_RAMWR); // write to RAM
+  if(!SSIFrame16 && ((uint32_t)(x1-x0+1)*(y1-y0+1) >= SSI16_MIN_PIXELS)){
+    ssiFrame16();             // pixel-data mode (drains the SSI)
+  }
+  setDC(DC_DATA);
+  STAT_LEAVE();
+}
+
+
+// Send one pixel, most significant byte first: a single 16-bit
+// frame, or two 8-bit frames after a small window.  Only valid in
+// pixel-data mode (after setAddrWindow).
+// Requires 2 bytes of transmission
+void static writepixel(uint16_t color) {
+  COUNT_PIXELS(1);
+#if ST7735_FRAMEBUFFER
+  if(FBActive){
+    fbPixel(color);
+    return;
+  }
+#else
+  if(BandActive){
+    bandWrite(0, color, 0, 1);
+    return;
+  }
+#endif
+  if(!SSIFrame16){
+    writedata(color>>8);
+    writedata(color);
+    return;
+  }
+  while((SSI_SR&SSI_SR_TNF)==0){};      // wait until transmit FIFO not full
+  SSI_PUT(color);                       // data out
+  COUNT_BYTES(2);
 }
 
 
-// Send two bytes of data, most significant byte first
+// Send one pixel, most significant byte first
 // Requires 2 bytes of transmission
 void static pushColor(uint16_t color) {
-  writedata((uint8_t)(color >> 8));
-  writedata((uint8_t)color);
+  writepixel(color);
+}
+
+
+// Send n pixels of one color, writepixel() unrolled by four
+// Requires 2*n bytes of transmission
+static inline void writepixels(uint16_t color, uint32_t n) {
+  while(n >= 4){
+    writepixel(color);
+    writepixel(color);
+    writepixel(color);
+    writepixel(color);
+    n = n - 4;
+  }
+  while(n){
+    writepixel(color);
+    n = n - 1;
+  }
+}
+
+
+// Send n pixels from src, writepixel() unrolled by four
+// Requires 2*n bytes of transmission
+static inline void copypixels(const uint16_t *src, uint32_t n) {
+  while(n >= 4){
+    writepixel(src[0]);
+    writepixel(src[1]);
+    writepixel(src[2]);
+    writepixel(src[3]);
+    src = src + 4;
+    n = n - 4;
+  }
+  while(n){
+    writepixel(*src);
+    src = src + 1;
+    n = n - 1;
+  }
 }
 
  
 //------------ST7735_DrawPixel------------
 // Color the pixel at the given coordinates with the given color.
-// Requires 13 bytes of transmission
+// Requires 13 bytes of transmission, 8 when the row or the column
+// is the same as the last window's, 3 when both are
 // Input: x     horizontal position of the pixel, columns from the left edge
 //               must be less than 128
 //               0 is on the left, 126 is near the right
@@ -851,6 +1784,7 @@ void static pushColor(uint16_t color) {
 //        color 16-bit color, which can be produced by ST7735_Color565()
 // Output: none
 void ST7735_DrawPixel(int16_t x, int16_t y, uint16_t color) {
+  STAT_CALL(ST7735_PRIM_PIXEL);
 
   if((x < 0) || (x >= _width) || (y < 0) || (y >= _height)) return;
 
@@ -860,28 +1794,47 @@ void ST7735_DrawPixel(int16_t x, int16_t y, uint16_t color) {
   pushColor(color);
 }
 
-//------------ST7735_DrawCircle------------
-// Draw a circle with the given radius and color.
-// Input: x     horizontal position of the start of the line, columns from the left edge
-//        y     vertical position of the start of the line, rows from the top edge
-//        r     radius of the circle
-//        color 16-bit color, which can be produced by ST7735_Color565()
-// Output: none
-void ST7735_DrawCircle(uint8_t x0, uint8_t y0, uint8_t r, uint16_t color)
-{
+// Midpoint circle rasterizers.  Going around one octant, x grows
+// by one each step and y stays the same for a run of steps, so
+// each run of the outline is one horizontal line (and, mirrored
+// across the diagonal, one vertical line) instead of a window
+// per pixel.  The run spans a..b at height y from the center.
+void static circleRuns(int16_t x0, int16_t y0, int16_t a, int16_t b, int16_t y, uint16_t color) {
+  int16_t n = b - a + 1;
+  ST7735_DrawFastHLine(x0 + a, y0 + y, n, color);
+  ST7735_DrawFastHLine(x0 - b, y0 + y, n, color);
+  ST7735_DrawFastHLine(x0 + a, y0 - y, n, color);
+  ST7735_DrawFastHLine(x0 - b, y0 - y, n, color);
+  ST7735_DrawFastVLine(x0 + y, y0 + a, n, color);
+  ST7735_DrawFastVLine(x0 + y, y0 - b, n, color);
+  ST7735_DrawFastVLine(x0 - y, y0 + a, n, color);
+  ST7735_DrawFastVLine(x0 - y, y0 - b, n, color);
+}
+
+// For a filled circle the same run gives row y (half width b) and,
+// mirrored, the band of rows a..b (half width y) as one rectangle.
+void static circleFill(int16_t x0, int16_t y0, int16_t a, int16_t b, int16_t y, uint16_t color) {
+  int16_t n = b - a + 1;
+  ST7735_DrawFastHLine(x0 - b, y0 + y, 2*b + 1, color);
+  ST7735_DrawFastHLine(x0 - b, y0 - y, 2*b + 1, color);
+  ST7735_FillRect(x0 - y, y0 + a, 2*y + 1, n, color);
+  ST7735_FillRect(x0 - y, y0 - b, 2*y + 1, n, color);
+}
+
+// Walk one octant of a circle of radius r and hand each run to emit
+void static circleWalk(uint8_t x0, uint8_t y0, uint8_t r, uint16_t color,
+                       void (*emit)(int16_t, int16_t, int16_t, int16_t, int16_t, uint16_t)) {
   int16_t f = 1 - r;
   int16_t ddF_x = 1;
   int16_t ddF_y = -2 * r;
   int16_t x = 0;
   int16_t y = r;
-
-  ST7735_DrawPixel(x0, y0+r, color);
-  ST7735_DrawPixel(x0, y0-r, color);
-  ST7735_DrawPixel(x0+r, y0, color);
-  ST7735_DrawPixel(x0-r, y0, color);
+  int16_t xs = 0;                       // first x of the current run
 
   while (x<y) {
     if (f >= 0) {
+      emit(x0, y0, xs, x, y, color);    // the run at height y ends at x
+      xs = x + 1;
       y--;
       ddF_y += 2;
       f += ddF_y;
@@ -889,103 +1842,138 @@ void ST7735_DrawCircle(uint8_t x0, uint8_t y0, uint8_t r, uint16_t color)
     x++;
     ddF_x += 2;
     f += ddF_x;
-  
-    ST7735_DrawPixel(x0 + x, y0 + y, color);
-    ST7735_DrawPixel(x0 - x, y0 + y, color);
-    ST7735_DrawPixel(x0 + x, y0 - y, color);
-    ST7735_DrawPixel(x0 - x, y0 - y, color);
-    
-    ST7735_DrawPixel(x0 + y, y0 + x, color);
-    ST7735_DrawPixel(x0 - y, y0 + x, color);
-    ST7735_DrawPixel(x0 + y, y0 - x, color);
-    ST7735_DrawPixel(x0 - y, y0 - x, color);
-    
   }
+  emit(x0, y0, xs, x, y, color);
+}
+
+//------------ST7735_DrawCircle------------
+// Draw a circle with the given radius and color.
+// Each run of the outline is sent as one horizontal or vertical line.
+// Input: x     horizontal position of the start of the line, columns from the left edge
+//        y     vertical position of the start of the line, rows from the top edge
+//        r     radius of the circle
+//        color 16-bit color, which can be produced by ST7735_Color565()
+// Output: none
+void ST7735_DrawCircle(uint8_t x0, uint8_t y0, uint8_t r, uint16_t color)
+{
+  circleWalk(x0, y0, r, color, circleRuns);
 }
  
 //------------ST7735_FillCircle------------
 // Fill a circle with the given radius and color.
+// Rows of the same width near the middle are sent as one rectangle.
 // Input: x     horizontal position of the start of the line, columns from the left edge
 //        y     vertical position of the start of the line, rows from the top edge
 //        r     radius of the circle
 //        color 16-bit color, which can be produced by ST7735_Color565()
 // Output: none
- void ST7735_FillCircle(uint8_t x0, uint8_t y0, uint8_t r, uint16_t color) {
-	int16_t f = 1 - r;
-  int16_t ddF_x = 1;
-  int16_t ddF_y = -2 * r;
-  int16_t x = 0;
-  int16_t y = r;
-
-  ST7735_DrawFastVLine(x0, y0-r, 2*r+1, color);
-
-  while (x<y) {
-    if (f >= 0) {
-      y--;
-      ddF_y += 2;
-      f += ddF_y;
-    }
-    x++;
-    ddF_x += 2;
-    f += ddF_x;
-  
-    ST7735_DrawFastVLine(x0+x, y0-y, 2*y+1, color);
-    ST7735_DrawFastVLine(x0-x, y0-y, 2*y+1, color);
-    ST7735_DrawFastVLine(x0+y, y0-x, 2*x+1, color);
-    ST7735_DrawFastVLine(x0-y, y0-x, 2*x+1, color);
-  }
- }
+void ST7735_FillCircle(uint8_t x0, uint8_t y0, uint8_t r, uint16_t color) {
+  circleWalk(x0, y0, r, color, circleFill);
+}
  
 //------------ST7735_DrawLine------------
-// Draw a  line at the given coordinates with the given height and color.
-// Requires (11 + 2*h) bytes of transmission (assuming image fully on screen)
-// Input: x     horizontal position of the start of the line, columns from the left edge
-//        y     vertical position of the start of the line, rows from the top edge
-//        h     height of the line
+// Draw a line between two points with the given color.
+// Consecutive pixels on the same row (or, for steep lines, the same
+// column) are sent as one horizontal (vertical) line.
+// Requires (11 + 2*n) bytes of transmission per run of n pixels (assuming image fully on screen)
+// Input: x0    horizontal position of the start of the line, columns from the left edge
+//        y0    vertical position of the start of the line, rows from the top edge
+//        x1    horizontal position of the end of the line, columns from the left edge
+//        y1    vertical position of the end of the line, rows from the top edge
 //        color 16-bit color, which can be produced by ST7735_Color565()
 // Output: none
- 
- void ST7735_DrawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
- 
-	 int16_t steep = abs(y1 - y0) > abs(x1 - x0);
-	 int16_t dx, dy;
-	 int16_t err, ystep;
-		if (steep) {
-			swap(x0, y0);
-			swap(x1, y1);
-		}
-
-		if (x0 > x1) {
-			swap(x0, x1);
-			swap(y0, y1);
-		}
-
-		
-		dx = x1 - x0;
-		dy = abs(y1 - y0);
-
-		err = dx / 2;
-		
-
-		if (y0 < y1) {
-			ystep = 1;
-			} else {
-			ystep = -1;
-		}
-
-		for (; x0<=x1; x0++) {
-			if (steep) {
-				ST7735_DrawPixel(y0, x0, color);
-				} else {
-				ST7735_DrawPixel(x0, y0, color);
-			}
-			err -= dy;
-			if (err < 0) {
-				y0 += ystep;
-				err += dx;
-			}
-		}
+void ST7735_DrawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+  int16_t steep = abs(y1 - y0) > abs(x1 - x0);
+  int16_t dx, dy;
+  int16_t err, ystep, xs;
+  if (steep) {
+    swap(x0, y0);
+    swap(x1, y1);
+  }
+  if (x0 > x1) {
+    swap(x0, x1);
+    swap(y0, y1);
+  }
+  dx = x1 - x0;
+  dy = abs(y1 - y0);
+  err = dx / 2;
+  if (y0 < y1) {
+    ystep = 1;
+  } else {
+    ystep = -1;
+  }
+
+  for (xs = x0; x0 <= x1; x0++) {
+    err -= dy;
+    if ((err < 0) || (x0 == x1)) {      // last pixel of this run
+      if (steep) {
+        ST7735_DrawFastVLine(y0, xs, x0 - xs + 1, color);
+      } else {
+        ST7735_DrawFastHLine(xs, y0, x0 - xs + 1, color);
+      }
+      xs = x0 + 1;
     }
+    if (err < 0) {
+      y0 += ystep;
+      err += dx;
+    }
+  }
+}
+
+//------------ST7735_FillTriangle------------
+// Fill a triangle with the given corners and color, one horizontal
+// line per row.  Corners may be given in any order and may be off
+// the screen.
+// Requires (11 + 2*w) bytes of transmission per row of w pixels (assuming image fully on screen)
+// Input: x0,y0 first corner, columns from the left edge and rows from the top edge
+//        x1,y1 second corner
+//        x2,y2 third corner
+//        color 16-bit color, which can be produced by ST7735_Color565()
+// Output: none
+void ST7735_FillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                         int16_t x2, int16_t y2, uint16_t color) {
+  int16_t a, b, y, last;
+  int32_t sa = 0, sb = 0;
+  int16_t dx01, dy01, dx02, dy02, dx12, dy12;
+  // sort the corners by y: y0 <= y1 <= y2
+  if (y0 > y1) { swap(y0, y1); swap(x0, x1); }
+  if (y1 > y2) { swap(y2, y1); swap(x2, x1); }
+  if (y0 > y1) { swap(y0, y1); swap(x0, x1); }
+
+  if (y0 == y2) {                       // all on one row
+    a = b = x0;
+    if (x1 < a) a = x1; else if (x1 > b) b = x1;
+    if (x2 < a) a = x2; else if (x2 > b) b = x2;
+    ST7735_DrawFastHLine(a, y0, b - a + 1, color);
+    return;
+  }
+  dx01 = x1 - x0; dy01 = y1 - y0;
+  dx02 = x2 - x0; dy02 = y2 - y0;
+  dx12 = x2 - x1; dy12 = y2 - y1;
+
+  // upper part: edges 0-1 and 0-2; row y1 is included here unless
+  // the lower edge 1-2 is flat, then it belongs to the lower part
+  last = (y1 == y2) ? y1 : y1 - 1;
+  for (y = y0; y <= last; y++) {
+    a = x0 + sa / dy01;
+    b = x0 + sb / dy02;
+    sa += dx01;
+    sb += dx02;
+    if (a > b) swap(a, b);
+    ST7735_DrawFastHLine(a, y, b - a + 1, color);
+  }
+  // lower part: edges 1-2 and 0-2
+  sa = (int32_t)dx12 * (y - y1);
+  sb = (int32_t)dx02 * (y - y0);
+  for (; y <= y2; y++) {
+    a = x1 + sa / dy12;
+    b = x0 + sb / dy02;
+    sa += dx12;
+    sb += dx02;
+    if (a > b) swap(a, b);
+    ST7735_DrawFastHLine(a, y, b - a + 1, color);
+  }
+}
 //------------ST7735_DrawFastVLine------------
 // Draw a vertical line at the given coordinates with the given height and color.
 // A vertical line is parallel to the longer side of the rectangular display
@@ -996,16 +1984,16 @@ void ST7735_DrawCircle(uint8_t x0, uint8_t y0, uint8_t r, uint16_t color)
 //        color 16-bit color, which can be produced by ST7735_Color565()
 // Output: none
 void ST7735_DrawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
-  uint8_t hi = color >> 8, lo = color;
-
-  // Rudimentary clipping
-  if((x >= _width) || (y >= _height)) return;
+  STAT_CALL(ST7735_PRIM_VLINE);
+  // Clipping (the span rasterizers pass lines that run off any edge)
+  if((x < 0) || (x >= _width) || (y >= _height)) return;
+  if(y < 0){ h = h + y; y = 0; }
   if((y+h-1) >= _height) h = _height-y;
+  if(h <= 0) return;
   setAddrWindow(x, y, x, y+h-1);
 
   while (h--) {
-    writedata(hi);
-    writedata(lo);
+    writepixel(color);
   }
 }
 
@@ -1020,16 +2008,16 @@ void ST7735_DrawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
 //        color 16-bit color, which can be produced by ST7735_Color565()
 // Output: none
 void ST7735_DrawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
-  uint8_t hi = color >> 8, lo = color;
-
-  // Rudimentary clipping
-  if((x >= _width) || (y >= _height)) return;
+  STAT_CALL(ST7735_PRIM_HLINE);
+  // Clipping (the span rasterizers pass lines that run off any edge)
+  if((x >= _width) || (y < 0) || (y >= _height)) return;
+  if(x < 0){ w = w + x; x = 0; }
   if((x+w-1) >= _width)  w = _width-x;
+  if(w <= 0) return;
   setAddrWindow(x, y, x+w-1, y);
 
   while (w--) {
-    writedata(hi);
-    writedata(lo);
+    writepixel(color);
   }
 }
 
@@ -1055,36 +2043,708 @@ void ST7735_FillScreen(uint16_t color) {
 //        color 16-bit color, which can be produced by ST7735_Color565()
 // Output: none
 void ST7735_FillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
-  uint8_t hi = color >> 8, lo = color;
-
-  // rudimentary clipping (drawChar w/big text requires this)
+  STAT_CALL(ST7735_PRIM_FILLRECT);
+  // clipping (drawChar w/big text and FillCircle require this)
   if((x >= _width) || (y >= _height)) return;
+  if(x < 0){ w = w + x; x = 0; }
+  if(y < 0){ h = h + y; y = 0; }
   if((x + w - 1) >= _width)  w = _width  - x;
   if((y + h - 1) >= _height) h = _height - y;
+  if((w <= 0) || (h <= 0)) return;
 
   setAddrWindow(x, y, x+w-1, y+h-1);
 
-  for(y=h; y>0; y--) {
-    for(x=w; x>0; x--) {
-      writedata(hi);
-      writedata(lo);
-    }
+  if((w*h) >= DMA_MIN_PIXELS){
+    dmaStart(0, color, 0, w*h);         // large fills stream in the background
+    return;
   }
+  writepixels(color, w*h);
 }
 
 
-//------------ST7735_Color565------------
-// Pass 8-bit (each) R,G,B and get back 16-bit packed color.
-// Input: r red value
-//        g green value
-//        b blue value
-// Output: 16-bit color
-uint16_t ST7735_Color565(uint8_t r, uint8_t g, uint8_t b) {
-  return ((b & 0xF8) << 8) | ((g & 0xFC) << 3) | (r >> 3);
-}
-
-
-//------------ST7735_SwapColor------------
+//------------ST7735_PushColorDMA------------
+// Fill a rectangle with one color using the panel's uDMA channel.
+// The function returns as soon as the transfer is started;
+// the pixels are streamed to the LCD in the background.
+// Requires (11 + 2*w*h) bytes of transmission (assuming image fully on screen)
+// Input: x     horizontal position of the top left corner of the rectangle, columns from the left edge
+//        y     vertical position of the top left corner of the rectangle, rows from the top edge
+//        w     horizontal width of the rectangle
+//        h     vertical height of the rectangle
+//        color 16-bit color, which can be produced by ST7735_Color565()
+// Output: none
+void ST7735_PushColorDMA(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  STAT_CALL(ST7735_PRIM_FILLRECT);
+  if((x < 0) || (y < 0) || (x >= _width) || (y >= _height) || (w <= 0) || (h <= 0)) return;
+  if((x + w - 1) >= _width)  w = _width  - x;
+  if((y + h - 1) >= _height) h = _height - y;
+
+  setAddrWindow(x, y, x+w-1, y+h-1);
+  dmaStart(0, color, 0, w*h);
+}
+
+
+//------------ST7735_PushPixelsDMA------------
+// Copy a buffer of pixels to a rectangle using the panel's uDMA channel.
+// The function returns as soon as the transfer is started; the
+// buffer must not be changed until ST7735_DMABusy() returns 0.
+// Pixels are sent left to right, top to bottom (unlike
+// ST7735_DrawBitmap(), which expects bottom-up BMP order).
+// Requires (11 + 2*w*h) bytes of transmission
+// Input: x      horizontal position of the top left corner of the rectangle, columns from the left edge
+//        y      vertical position of the top left corner of the rectangle, rows from the top edge
+//        w      horizontal width of the rectangle
+//        h      vertical height of the rectangle
+//        pixels pointer to w*h 16-bit colors
+// Output: none
+// The rectangle must be fully on the screen, otherwise nothing is drawn
+void ST7735_PushPixelsDMA(int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t *pixels) {
+  STAT_CALL(ST7735_PRIM_BITMAP);
+  if((x < 0) || (y < 0) || (w <= 0) || (h <= 0) ||
+     ((x + w) > _width) || ((y + h) > _height)) return;
+
+  setAddrWindow(x, y, x+w-1, y+h-1);
+  dmaStart(pixels, 0, 1, w*h);
+}
+
+
+//------------ST7735_DMABusy------------
+// Check whether a background uDMA pixel stream or the draw queue
+// is in progress.
+// Input: none
+// Output: 1 if the uDMA still owns the selected panel's SSI, 0 if idle
+int ST7735_DMABusy(void) {
+  return DMABusy || (QueueRunning && (Panel == &Panels[0]));
+}
+
+
+//------------ST7735_DMAWait------------
+// Wait for the selected panel's background uDMA pixel stream (and,
+// on panel 0, the draw queue) to finish.
+// Input: none
+// Output: none
+void ST7735_DMAWait(void) {
+  while(ST7735_DMABusy()){};
+}
+
+
+//------------ST7735_SetDMACallback------------
+// Register a function to be called when a uDMA pixel stream of the
+// selected panel completes.  The function runs in that panel's SSI
+// handler (interrupt context) with the panel selected, and should be
+// short.
+// Input: task pointer to a function, or 0 for no callback
+// Output: none
+void ST7735_SetDMACallback(void (*task)(void)) {
+  DMACallback = task;
+}
+
+
+//------------ST7735_StreamingSSI------------
+// Find the SSI modules still in use by uDMA pixel streams or the
+// draw queue, for clock gating in sleep mode.
+// Input: none
+// Output: bit n set while SSIn is streaming (bit 0 for panel 0)
+uint32_t ST7735_StreamingSSI(void) {
+  uint32_t modules = QueueRunning ? 1 : 0;
+  for(int n = 0; n < ST7735_PANELS; n++){
+    if(Panels[n].dmaBusy) modules |= 1u<<Wiring[n].ssiNum;
+  }
+  return modules;
+}
+
+
+//------------ST7735_PanelPorts------------
+// Find the GPIO ports that the panels set up with ST7735_InitR,
+// ST7735_InitB or ST7735_StartInitR are wired to (SCK, MOSI, TFT_CS,
+// Data/Command and RESET), for clock gating in sleep mode: their
+// streams keep running while the core sleeps.
+// Input: none
+// Output: bit n set for GPIO port n (bit 0 for port A), as in RCGCGPIO
+uint32_t ST7735_PanelPorts(void) {
+  uint32_t ports = 0;
+  for(int n = 0; n < ST7735_PANELS; n++){
+    if(Panels[n].ssi) ports |= (1u<<Wiring[n].portNum)|(1u<<Wiring[n].ctlPortNum);
+  }
+  return ports;
+}
+
+
+//------------ST7735_SelectPanel------------
+// Choose the panel that the following driver calls draw on.  Call
+// ST7735_InitR (or ST7735_InitB) once for each panel after selecting
+// it.  A background stream on the previous panel keeps going.
+// Input: n panel number, 0 to ST7735_PANELS-1; others are ignored
+// Output: none
+void ST7735_SelectPanel(uint8_t n) {
+  if(n < ST7735_PANELS) Panel = &Panels[n];
+}
+
+
+//------------ST7735_CurrentPanel------------
+// Find the panel chosen by ST7735_SelectPanel.
+// Input: none
+// Output: panel number, 0 to ST7735_PANELS-1
+uint8_t ST7735_CurrentPanel(void) {
+  return Panel - Panels;
+}
+
+
+#if ST7735_FRAMEBUFFER
+//------------ST7735_SetFramebuffer------------
+// Turn the off-screen framebuffer on or off.  While it is on,
+// all drawing functions render into RAM and nothing is sent to
+// the LCD until ST7735_Flush().  The first time it is turned on
+// the framebuffer is cleared to black, which matches the screen
+// after ST7735_InitR().  Drawing done while the framebuffer is
+// off is sent directly to the LCD and is not seen by the framebuffer.
+// Turning it off flushes any pending changes first.
+// Input: enable non-zero to draw into the framebuffer, 0 to draw directly
+// Output: none
+void ST7735_SetFramebuffer(int enable) {
+  if(enable){
+    if(!FBReady){
+      fbPaletteReset();
+      memset(FrameBuffer, fbIndex(ST7735_BLACK), FB_SIZE);
+      NumDirty = 0;
+      FBReady = 1;
+    }
+    FBActive = 1;
+  } else{
+    ST7735_Flush();
+    FBActive = 0;
+  }
+}
+
+
+// Send one rectangle of the framebuffer to the LCD, see ST7735_Flush().
+// The caller clears FBActive so the window and pixels go to the LCD.
+void static fbSend(const DirtyRect *r) {
+  uint32_t row, col, w, h;
+  uint8_t *src;
+  uint16_t *dst;
+  uint8_t buf = 0;
+  w = r->x1 - r->x0 + 1;
+  h = r->y1 - r->y0 + 1;
+  setAddrWindow(r->x0, r->y0, r->x1, r->y1);
+  for(row=r->y0; row<=r->y1; row=row+1){
+    src = &FrameBuffer[row*_width + r->x0];
+    if((w*h) < DMA_MIN_PIXELS){         // too small to be worth a uDMA setup
+      for(col=0; col<w; col=col+1){
+        writepixel(Palette[src[col]]);
+      }
+    } else{
+      dst = LineBuffer[buf];            // the uDMA is done with this one
+      for(col=0; col<w; col=col+1){
+        dst[col] = Palette[src[col]];
+      }
+      while(DMABusy){};                 // the other line buffer is done
+      dmaStart(dst, 0, 1, w);
+      buf = buf^1;
+    }
+  }
+}
+
+
+//------------ST7735_Flush------------
+// Send the dirty regions of the framebuffer to the LCD.  Each
+// dirty rectangle costs one address window; rows are expanded
+// through the palette into a line buffer and streamed with the
+// uDMA while the next row is being expanded.
+// Requires (11 + 2*w*h) bytes of transmission per dirty rectangle
+// Input: none
+// Output: none
+void ST7735_Flush(void) {
+  uint32_t i;
+  STAT_CALL(ST7735_PRIM_FLUSH);
+  if(!FBActive) return;
+  FBActive = 0;                         // setAddrWindow() and writepixel() go to the LCD
+  for(i=0; i<NumDirty; i=i+1){
+    fbSend(&Dirty[i]);
+  }
+  NumDirty = 0;
+  FBActive = 1;
+}
+
+
+//------------ST7735_CaptureScreen------------
+// Encode the framebuffer into a compact screen image that
+// ST7735_DrawScreen() can send back to the LCD with one address
+// window.  The screen is cut into bands of rows: a band of one color
+// is stored as that color, a band of rows that all hold the same two
+// colors (text on a plain background) as a 1 bit per pixel mask over
+// the columns that hold the second color.  Meant for static layouts
+// drawn from fills and text; a row with three or more colors makes
+// the capture fail.  The image is only valid in the rotation it was
+// captured in.
+// a band:  0, rows, color (2 bytes, low byte first)     one color
+//          1, rows, x0, x1, bg (2), fg (2), mask        two colors
+//          mask is rows*((x1-x0+8)/8) bytes, bit 7 first, 1 = fg
+// the end: 0xFF
+// Input: buf  where to store the image
+//        size number of bytes available at buf
+// Output: number of bytes used, 0 if the framebuffer is off, a row
+//         has more than two colors or buf is too small
+uint32_t ST7735_CaptureScreen(uint8_t *buf, uint32_t size) {
+  uint32_t n = 0, row, last, col, i, bytes;
+  uint32_t width = _width, height = _height; // compared with the unsigned counters
+  uint8_t *src;
+  uint8_t bgIndex, fgIndex, two, hasFg, x0, x1, rx0, rx1;
+  if(!FBActive) return 0;
+  row = 0;
+  while(row < height){
+    // the first row of a band sets its colors
+    src = &FrameBuffer[row*width];
+    bgIndex = fgIndex = src[0];
+    for(col=1; col<width; col=col+1){
+      if(src[col] != bgIndex){
+        fgIndex = src[col];
+        break;
+      }
+    }
+    two = (fgIndex != bgIndex);
+    // one-color bands end at a row with another color, two-color
+    // bands at a row without the second color or with a third
+    x0 = width - 1;
+    x1 = 0;
+    for(last=row; (last<height) && (last-row<255); last=last+1){
+      src = &FrameBuffer[last*width];
+      hasFg = 0;
+      rx0 = width - 1;
+      rx1 = 0;
+      for(col=0; col<width; col=col+1){
+        if(src[col] == bgIndex) continue;
+        if(!two || (src[col] != fgIndex)) break;
+        if(!hasFg) rx0 = col;
+        rx1 = col;
+        hasFg = 1;
+      }
+      if((col < width) || (two && !hasFg)) break;
+      if(rx0 < x0) x0 = rx0;
+      if(rx1 > x1) x1 = rx1;
+    }
+    if(last == row) return 0;           // more than two colors on this row
+    if(two){
+      bytes = (x1 - x0 + 8)/8;
+      if(n + 8 + (last-row)*bytes + 1 > size) return 0;
+      buf[n] = 1;
+      buf[n+1] = last - row;
+      buf[n+2] = x0;
+      buf[n+3] = x1;
+      buf[n+4] = Palette[bgIndex]&0xFF;
+      buf[n+5] = Palette[bgIndex]>>8;
+      buf[n+6] = Palette[fgIndex]&0xFF;
+      buf[n+7] = Palette[fgIndex]>>8;
+      n = n + 8;
+      for(i=row; i<last; i=i+1){
+        src = &FrameBuffer[i*width];
+        memset(&buf[n], 0, bytes);
+        for(col=x0; col<=x1; col=col+1){
+          if(src[col] == fgIndex){
+            buf[n + (col-x0)/8] |= 0x80>>((col-x0)%8);
+          }
+        }
+        n = n + bytes;
+      }
+    } else{
+      if(n + 4 + 1 > size) return 0;
+      buf[n] = 0;
+      buf[n+1] = last - row;
+      buf[n+2] = Palette[bgIndex]&0xFF;
+      buf[n+3] = Palette[bgIndex]>>8;
+      n = n + 4;
+    }
+    row = last;
+  }
+  buf[n] = 0xFF;
+  return n + 1;
+}
+
+
+// ---- Sprite layer ----
+// Moving objects are kept out of the normal drawing path.  Each
+// ST7735_UpdateSprites() call looks for the sprites that moved or
+// changed, and for each one rebuilds only the rectangle it left and
+// the one it now covers: the background fill color first, then every
+// sprite touching the rectangle in the order they were added (later
+// sprites on top).  The rectangle is then sent to the LCD at once, so
+// moving sprites never grow the framebuffer's dirty rectangles.
+#define SPRITE_MAX          64          // sprites registered at one time
+#define SPRITE_WINDOW_BYTES 11          // cost of one address window
+static ST7735_Sprite *Sprites[SPRITE_MAX]; // in drawing order
+static uint8_t NumSprites;
+static DirtyRect SpriteArea = {0, 0, ST7735_TFTWIDTH-1, ST7735_TFTHEIGHT-1};
+static uint16_t SpriteBg;               // background under the sprite area
+
+// Rectangle of a sprite inside the sprite area, returns 0 if it is hidden or outside
+int static spriteClip(const ST7735_Sprite *s, DirtyRect *r) {
+  int16_t x0 = s->x, y0 = s->y, x1 = s->x + s->w - 1, y1 = s->y + s->h - 1;
+  if(!s->visible) return 0;
+  if(x0 < SpriteArea.x0) x0 = SpriteArea.x0;
+  if(y0 < SpriteArea.y0) y0 = SpriteArea.y0;
+  if(x1 > SpriteArea.x1) x1 = SpriteArea.x1;
+  if(y1 > SpriteArea.y1) y1 = SpriteArea.y1;
+  if((x0 > x1) || (y0 > y1)) return 0;
+  r->x0 = x0; r->y0 = y0; r->x1 = x1; r->y1 = y1;
+  return 1;
+}
+
+// Draw the part of a sprite inside r into the framebuffer
+void static spriteDraw(const ST7735_Sprite *s, const DirtyRect *r) {
+  int16_t x0 = s->x, y0 = s->y, x1 = s->x + s->w - 1, y1 = s->y + s->h - 1;
+  int16_t x, y;
+  const uint16_t *src;
+  uint8_t *dst;
+  if(!s->visible) return;
+  if(x0 < r->x0) x0 = r->x0;
+  if(y0 < r->y0) y0 = r->y0;
+  if(x1 > r->x1) x1 = r->x1;
+  if(y1 > r->y1) y1 = r->y1;
+  if((x0 > x1) || (y0 > y1)) return;
+  for(y=y0; y<=y1; y=y+1){
+    dst = &FrameBuffer[y*_width + x0];
+    if(s->image == 0){                  // solid block
+      memset(dst, fbIndex(s->color), x1 - x0 + 1);
+    } else{                             // bottom row first, like bitmaps.h
+      src = &s->image[(s->h - 1 - (y - s->y))*s->w + (x0 - s->x)];
+      for(x=x0; x<=x1; x=x+1){
+        if(*src != s->color) *dst = fbIndex(*src);
+        src++;
+        dst++;
+      }
+    }
+  }
+}
+
+// Rebuild r from the background and the sprites over it, then send it
+void static spriteRegion(const DirtyRect *r) {
+  uint32_t i;
+  uint16_t y;
+  uint8_t bgIndex = fbIndex(SpriteBg);
+  for(y=r->y0; y<=r->y1; y=y+1){
+    memset(&FrameBuffer[y*_width + r->x0], bgIndex, r->x1 - r->x0 + 1);
+  }
+  for(i=0; i<NumSprites; i=i+1){
+    spriteDraw(Sprites[i], r);
+  }
+  FBActive = 0;
+  fbSend(r);
+  FBActive = 1;
+}
+
+
+//------------ST7735_SetSpriteArea------------
+// Set the part of the screen sprites are drawn in and the color
+// behind them.  Sprite pixels outside the area are not drawn, and
+// the area must be plain background wherever a sprite can go: what
+// a sprite leaves is filled back with bgColor.
+// Input: x     horizontal position of the top left corner of the area, columns from the left edge
+//        y     vertical position of the top left corner of the area, rows from the top edge
+//        w     horizontal width of the area
+//        h     vertical height of the area
+//        bgColor 16-bit color of the background under the sprites
+// Output: none
+void ST7735_SetSpriteArea(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t bgColor) {
+  if(x < 0){ w = w + x; x = 0; }
+  if(y < 0){ h = h + y; y = 0; }
+  if((x + w - 1) >= _width)  w = _width  - x;
+  if((y + h - 1) >= _height) h = _height - y;
+  SpriteBg = bgColor;
+  if((w <= 0) || (h <= 0)){             // empty: nothing will be drawn
+    SpriteArea.x0 = SpriteArea.y0 = 1;
+    SpriteArea.x1 = SpriteArea.y1 = 0;
+    return;
+  }
+  SpriteArea.x0 = x;
+  SpriteArea.y0 = y;
+  SpriteArea.x1 = x + w - 1;
+  SpriteArea.y1 = y + h - 1;
+}
+
+
+//------------ST7735_AddSprite------------
+// Register a sprite to be drawn by ST7735_UpdateSprites().  Sprites
+// added later are drawn on top of earlier ones.  The sprite is not
+// copied; move it by changing its fields between updates.
+// Input: s pointer to the sprite, stays in use until ST7735_ClearSprites()
+// Output: index of the sprite in drawing order, -1 if SPRITE_MAX are registered
+int ST7735_AddSprite(ST7735_Sprite *s) {
+  if(NumSprites >= SPRITE_MAX) return -1;
+  s->shown = 0;                         // drawn by the next update
+  Sprites[NumSprites] = s;
+  NumSprites = NumSprites + 1;
+  return NumSprites - 1;
+}
+
+
+//------------ST7735_ClearSprites------------
+// Forget all sprites without erasing them, for when the screen
+// under them is about to be redrawn.
+// Input: none
+// Output: none
+void ST7735_ClearSprites(void) {
+  NumSprites = 0;
+}
+
+
+//------------ST7735_UpdateSprites------------
+// Bring the LCD up to date with the sprites.  For each sprite that
+// moved, changed image or color, or was hidden or shown, the
+// rectangle it was shown in and the one it covers now are rebuilt in
+// the framebuffer and sent: as their bounding box when that is fewer
+// bytes than two address windows, otherwise one by one.  Sprites that
+// did not change cost nothing.  Does nothing while the framebuffer is off.
+// Requires (11 + 2*w*h) bytes of transmission per rectangle sent
+// Input: none
+// Output: none
+void ST7735_UpdateSprites(void) {
+  uint32_t i, areaOld, areaNew, areaBoth;
+  ST7735_Sprite *s;
+  DirtyRect now = {0, 0, 0, 0}, old, both;
+  int inNow;
+  STAT_CALL(ST7735_PRIM_FLUSH);
+  if(!FBActive) return;
+  for(i=0; i<NumSprites; i=i+1){
+    s = Sprites[i];
+    inNow = spriteClip(s, &now);
+    old.x0 = s->shownX0; old.y0 = s->shownY0; old.x1 = s->shownX1; old.y1 = s->shownY1;
+    if(!inNow && !s->shown) continue;   // still off the area
+    if(inNow && s->shown && (now.x0 == old.x0) && (now.y0 == old.y0) &&
+       (now.x1 == old.x1) && (now.y1 == old.y1) &&
+       (s->image == s->shownImage) && (s->color == s->shownColor)) continue;
+    if(inNow && s->shown){
+      both.x0 = (old.x0 < now.x0) ? old.x0 : now.x0;
+      both.y0 = (old.y0 < now.y0) ? old.y0 : now.y0;
+      both.x1 = (old.x1 > now.x1) ? old.x1 : now.x1;
+      both.y1 = (old.y1 > now.y1) ? old.y1 : now.y1;
+      areaOld = (old.x1 - old.x0 + 1)*(old.y1 - old.y0 + 1);
+      areaNew = (now.x1 - now.x0 + 1)*(now.y1 - now.y0 + 1);
+      areaBoth = (both.x1 - both.x0 + 1)*(both.y1 - both.y0 + 1);
+      if(2*areaBoth <= 2*(areaOld + areaNew) + SPRITE_WINDOW_BYTES){
+        spriteRegion(&both);
+      } else{                           // far apart: two windows
+        spriteRegion(&old);
+        spriteRegion(&now);
+      }
+    } else if(s->shown){                // hidden or moved out of the area
+      spriteRegion(&old);
+    } else{
+      spriteRegion(&now);
+    }
+    s->shown = inNow;
+    s->shownX0 = now.x0; s->shownY0 = now.y0; s->shownX1 = now.x1; s->shownY1 = now.y1;
+    s->shownImage = s->image;
+    s->shownColor = s->color;
+  }
+}
+// ---- End sprite layer ----
+#endif
+
+
+//------------ST7735_DrawScreen------------
+// Send a screen image made by ST7735_CaptureScreen() to the whole
+// screen through one address window.  One-color bands are a single
+// uDMA fill; two-color bands are expanded a row at a time into a
+// line buffer and streamed with the uDMA.
+// Requires (11 + 2*_width*_height) bytes of transmission
+// Input: image pointer to the encoded screen
+// Output: none
+void ST7735_DrawScreen(const uint8_t *image) {
+  uint32_t rows, bytes, col, i;
+  uint16_t bg, fg;
+  uint8_t x0, x1, buf = 0;
+  uint16_t *dst;
+  STAT_CALL(ST7735_PRIM_SCREEN);
+  setAddrWindow(0, 0, _width-1, _height-1);
+  while(image[0] != 0xFF){
+    rows = image[1];
+    if(image[0] == 0){                  // one color
+      while(DMABusy){};
+      dmaStart(0, image[2] | (image[3]<<8), 0, rows*_width);
+      image = image + 4;
+    } else{                             // two colors, mask over x0 to x1
+      x0 = image[2];
+      x1 = image[3];
+      bg = image[4] | (image[5]<<8);
+      fg = image[6] | (image[7]<<8);
+      bytes = (x1 - x0 + 8)/8;
+      image = image + 8;
+      for(i=0; i<rows; i=i+1){
+        dst = LineBuffer[buf];          // the uDMA is done with this one
+        for(col=0; col<(uint32_t)_width; col=col+1){
+          if((col >= x0) && (col <= x1) && (image[(col-x0)/8]&(0x80>>((col-x0)%8)))){
+            dst[col] = fg;
+          } else{
+            dst[col] = bg;
+          }
+        }
+        while(DMABusy){};               // the other line buffer is done
+        dmaStart(dst, 0, 1, _width);
+        buf = buf^1;
+        image = image + bytes;
+      }
+    }
+  }
+}
+
+
+// Draw one display list operation
+void static drawOp(const ST7735_DrawOp *op) {
+  switch(op->op){
+    case ST7735_OP_FILLRECT:
+      ST7735_FillRect(op->x, op->y, op->w, op->h, op->color);
+      break;
+    case ST7735_OP_TEXT:
+      ST7735_DrawText(op->x, op->y, (const char *)op->data, op->color, op->bgColor, op->size);
+      break;
+    case ST7735_OP_RLEIMAGE:
+      ST7735_DrawRLEImage(op->x, op->y, (const ST7735_RLEImage *)op->data, op->size);
+      break;
+    case ST7735_OP_BITMAP:
+      ST7735_DrawBitmap(op->x, op->y, (const uint16_t *)op->data, op->w, op->h);
+      break;
+    case ST7735_OP_PIXELS:
+      ST7735_PushPixelsDMA(op->x, op->y, op->w, op->h, (const uint16_t *)op->data);
+      break;
+  }
+}
+
+#if !ST7735_FRAMEBUFFER
+// Rows top..bottom covered by a display list operation
+void static opRows(const ST7735_DrawOp *op, int16_t *top, int16_t *bottom) {
+  uint8_t size = op->size ? op->size : 1;
+  switch(op->op){
+    case ST7735_OP_TEXT:
+      *top = op->y;
+      *bottom = op->y + 8*size - 1;
+      break;
+    case ST7735_OP_RLEIMAGE:
+      *top = op->y;
+      *bottom = op->y + ((const ST7735_RLEImage *)op->data)->h*size - 1;
+      break;
+    case ST7735_OP_BITMAP:              // y is the bottom row
+      *top = op->y - op->h + 1;
+      *bottom = op->y;
+      break;
+    default:
+      *top = op->y;
+      *bottom = op->y + op->h - 1;
+      break;
+  }
+}
+#endif
+
+
+//------------ST7735_DrawList------------
+// Draw a display list, operations first to last.  With the
+// framebuffer compiled in, the operations are simply drawn (into
+// the framebuffer while it is on).  Without it the screen is
+// rendered in bands of ST7735_BAND_ROWS rows: each band plays the
+// operations that touch it into one band buffer while the uDMA
+// sends the previous band from the other, so rendering and sending
+// overlap and nothing appears on the LCD half drawn.  In that case
+// the list must cover every pixel (start with a full-screen
+// ST7735_OP_FILLRECT), since bands are not cleared first.
+// Requires (11 + 2*_width*_height) bytes of transmission without the framebuffer
+// Input: list pointer to the operations
+//        n    number of operations
+// Output: none
+void ST7735_DrawList(const ST7735_DrawOp *list, uint32_t n) {
+  uint32_t i;
+#if ST7735_FRAMEBUFFER
+  for(i=0; i<n; i=i+1){
+    drawOp(&list[i]);
+  }
+#else
+  int16_t top, bottom;
+  uint8_t buf = 0;
+  for(BandY0=0; BandY0<_height; BandY0=BandY0+ST7735_BAND_ROWS){
+    BandY1 = BandY0 + ST7735_BAND_ROWS - 1;
+    if(BandY1 >= _height) BandY1 = _height - 1;
+    if(BandY0 == 0){
+      while(DMABusy){};                 // a stream from before the list may still read LineBuffer or a band
+    }
+    Band = BandBuffer[buf];             // the uDMA finished with it two bands ago
+    BandActive = 1;
+    for(i=0; i<n; i=i+1){
+      opRows(&list[i], &top, &bottom);
+      if((bottom >= BandY0) && (top <= BandY1)) drawOp(&list[i]);
+    }
+    BandActive = 0;
+    if(BandY0 == 0){
+      setAddrWindow(0, 0, _width-1, _height-1); // one window, the bands follow each other
+    } else{
+      while(DMABusy){};                 // previous band is out
+    }
+    dmaStart(Band, 0, 1, (BandY1 - BandY0 + 1)*_width);
+    buf = buf^1;
+  }
+#endif
+}
+
+
+#if ST7735_STATS
+//------------ST7735_BytesSent------------
+// Number of bytes sent to the LCDs since reset: commands, parameters
+// and pixels, including ones still queued for uDMA. Subtract two
+// readings to get the traffic of one operation.
+// Input: none
+// Output: byte count (wraps at 2^32)
+uint32_t ST7735_BytesSent(void) {
+  return BytesSent;
+}
+
+
+static const char *const PrimNames[ST7735_NUM_PRIMS] = {
+  "Window", "Pixel", "HLine", "VLine", "FillRect", "Bitmap", "BitmapScaled",
+  "RLEImage", "CharS", "Char", "Text", "Screen", "Flush", "Queue", "Other"
+};
+
+//------------ST7735_Stats------------
+// Counters of one drawing primitive since reset or the last
+// ST7735_ClearStats(): calls, pixels written and the command and
+// data bytes sent while it was the primitive entered last (see enum
+// ST7735_Prim).  Bytes of uDMA streams count when they are started.
+// Input: prim primitive, enum ST7735_Prim
+// Output: pointer to its counters, those of ST7735_PRIM_OTHER past the end
+const ST7735_PrimStats *ST7735_Stats(uint8_t prim) {
+  if(prim >= ST7735_NUM_PRIMS) prim = ST7735_PRIM_OTHER;
+  return &Stats[prim];
+}
+
+
+//------------ST7735_PrimName------------
+// Short name of a drawing primitive, for reports.
+// Input: prim primitive, enum ST7735_Prim
+// Output: pointer to a constant string, "" past ST7735_NUM_PRIMS
+const char *ST7735_PrimName(uint8_t prim) {
+  return (prim < ST7735_NUM_PRIMS) ? PrimNames[prim] : "";
+}
+
+
+//------------ST7735_ClearStats------------
+// Zero the counters of every drawing primitive, to measure from
+// here on.  ST7735_BytesSent() is not reset.
+// Input: none
+// Output: none
+void ST7735_ClearStats(void) {
+  memset(Stats, 0, sizeof(Stats));
+}
+#endif
+
+
+//------------ST7735_Color565------------
+// Pass 8-bit (each) R,G,B and get back 16-bit packed color.
+// Input: r red value
+//        g green value
+//        b blue value
+// Output: 16-bit color
+uint16_t ST7735_Color565(uint8_t r, uint8_t g, uint8_t b) {
+  return ((b & 0xF8) << 8) | ((g & 0xFC) << 3) | (r >> 3);
+}
+
+
+//------------ST7735_SwapColor------------
 // Swaps the red and blue values of the given 16-bit packed color;
 // green is unchanged.
 // Input: x 16-bit color in format B, G, R
@@ -1117,6 +2777,7 @@ void ST7735_DrawBitmap(int16_t x, int16_t y, const uint16_t *image, int16_t w, i
   int16_t skipC = 0;                      // non-zero if columns need to be skipped due to clipping
   int16_t originalWidth = w;              // save this value; even if not all columns fit on the screen, the image is still this width in ROM
   int i = w*(h - 1);
+  STAT_CALL(ST7735_PRIM_BITMAP);
 
   if((x >= _width) || ((y - h + 1) >= _height) || ((x + w) <= 0) || (y < 0)){
     return;                             // image is totally off the screen, do nothing
@@ -1150,19 +2811,163 @@ void ST7735_DrawBitmap(int16_t x, int16_t y, const uint16_t *image, int16_t w, i
   setAddrWindow(x, y-h+1, x+w-1, y);
 
   for(y=0; y<h; y=y+1){
-    for(x=0; x<w; x=x+1){
-                                        // send the top 8 bits
-      writedata((uint8_t)(image[i] >> 8));
-                                        // send the bottom 8 bits
-      writedata((uint8_t)image[i]);
-      i = i + 1;                        // go to the next pixel
-    }
-    i = i + skipC;
+    copypixels(&image[i], w);           // one row, all 16 bits of a pixel in one frame
+    i = i + w + skipC;
     i = i - 2*originalWidth;
   }
 }
 
 
+//------------ST7735_DrawBitmapScaled------------
+// Displays a 16-bit color image with every pixel enlarged to a
+// scale by scale square.  Only one address window is set up;
+// each source row is expanded and streamed scale times.
+// (x,y) is the screen location of the top left corner of the image
+// Requires (11 + 2*w*h*scale*scale) bytes of transmission (assuming image fully on screen)
+// Input: x     horizontal position of the top left corner of the image, columns from the left edge
+//        y     vertical position of the top left corner of the image, rows from the top edge
+//        image pointer to w*h 16-bit colors
+//        w     number of source pixels wide
+//        h     number of source pixels tall
+//        scale number of screen pixels per image pixel in each direction (1 or more)
+//        flags ST7735_FLIP_V if the rows of image[] are stored bottom-up
+//              (standard for bitmap files and for the icons in bitmaps.h), otherwise 0
+// Output: none
+void ST7735_DrawBitmapScaled(int16_t x, int16_t y, const uint16_t *image, int16_t w, int16_t h, uint8_t scale, uint8_t flags){
+  int32_t x0, y0, x1, y1;               // clipped screen rectangle, inclusive
+  int32_t row, col, srcRow, rep, first;
+  const uint16_t *src;
+  STAT_CALL(ST7735_PRIM_BITMAPSCALED);
+  if((scale == 0) || (w <= 0) || (h <= 0)) return;
+  x0 = x; y0 = y;
+  x1 = x + w*scale - 1;
+  y1 = y + h*scale - 1;
+  if(x0 < 0) x0 = 0;
+  if(y0 < 0) y0 = 0;
+  if(x1 >= _width)  x1 = _width - 1;
+  if(y1 >= _height) y1 = _height - 1;
+  if((x0 > x1) || (y0 > y1)) return;    // image is totally off the screen
+
+  setAddrWindow(x0, y0, x1, y1);
+
+  first = (x0 - x)/scale;               // first visible source column
+  for(row=y0; row<=y1; row=row+1){
+    srcRow = (row - y)/scale;
+    if(flags&ST7735_FLIP_V) srcRow = h - 1 - srcRow;
+    src = &image[srcRow*w + first];
+    rep = scale - (x0 - x)%scale;       // copies left of the first visible column
+    for(col=x0; col<=x1; col=col+1){
+      writepixel(*src);
+      rep = rep - 1;
+      if(rep == 0){
+        src++;
+        rep = scale;
+      }
+    }
+  }
+}
+
+
+// Decoder state for run-length encoded images (format in ST7735.h)
+typedef struct {
+  const uint8_t *pt;                    // next byte of the encoded stream
+  uint8_t count;                        // indices left in the current token
+  uint8_t run;                          // non-zero if the current token is a run
+  uint8_t value;                        // palette index repeated by the current run
+  uint8_t nibble;                       // 4-bit literals: non-zero if the low nibble of *pt is next
+} RLEState;
+
+// Return the next palette index of an encoded stream
+uint8_t static rleNext(RLEState *s, uint8_t bpp){
+  uint8_t token, index;
+  if(s->count == 0){
+    token = *(s->pt++);
+    if(token&0x80){
+      s->run = 1;
+      s->count = (token&0x7F) + 1;
+      s->value = *(s->pt++);
+    } else{
+      s->run = 0;
+      s->count = token + 1;
+      s->nibble = 0;
+    }
+  }
+  s->count = s->count - 1;
+  if(s->run) return s->value;
+  if(bpp == 8) return *(s->pt++);
+  if(s->nibble){
+    index = *(s->pt++)&0x0F;
+    s->nibble = 0;
+  } else{
+    index = *(s->pt)>>4;
+    s->nibble = 1;
+    if(s->count == 0) s->pt++;          // odd length literal, skip the pad nibble
+  }
+  return index;
+}
+
+
+//------------ST7735_DrawRLEImage------------
+// Displays a run-length encoded, palette-indexed image (see
+// ST7735_RLEImage in ST7735.h and rle_icons.py) with every pixel
+// enlarged to a scale by scale square.  The stream is decoded one
+// source row at a time and the colors are written straight into
+// the SSI FIFO through one address window.
+// (x,y) is the screen location of the top left corner of the image
+// Requires (11 + 2*w*h*scale*scale) bytes of transmission (assuming image fully on screen)
+// Input: x     horizontal position of the top left corner of the image, columns from the left edge
+//        y     vertical position of the top left corner of the image, rows from the top edge
+//        image pointer to the encoded image
+//        scale number of screen pixels per image pixel in each direction (1 or more)
+// Output: none
+// Must be less than or equal to 160 pixels wide
+void ST7735_DrawRLEImage(int16_t x, int16_t y, const ST7735_RLEImage *image, uint8_t scale){
+  uint8_t indices[ST7735_TFTHEIGHT];    // one decoded source row
+  STAT_CALL(ST7735_PRIM_RLEIMAGE);
+  RLEState s;
+  int32_t x0, y0, x1, y1;               // clipped screen rectangle, inclusive
+  int32_t row, col, srcRow, decoded, rep, first;
+  const uint8_t *src;
+  if((scale == 0) || (image->w == 0) || (image->h == 0) || (image->w > ST7735_TFTHEIGHT)) return;
+  x0 = x; y0 = y;
+  x1 = x + image->w*scale - 1;
+  y1 = y + image->h*scale - 1;
+  if(x0 < 0) x0 = 0;
+  if(y0 < 0) y0 = 0;
+  if(x1 >= _width)  x1 = _width - 1;
+  if(y1 >= _height) y1 = _height - 1;
+  if((x0 > x1) || (y0 > y1)) return;    // image is totally off the screen
+
+  setAddrWindow(x0, y0, x1, y1);
+
+  s.pt = image->data;
+  s.count = 0;
+  s.run = 0;
+  s.nibble = 0;
+  decoded = 0;                          // source rows decoded so far
+  first = (x0 - x)/scale;               // first visible source column
+  for(row=y0; row<=y1; row=row+1){
+    srcRow = (row - y)/scale;
+    while(decoded <= srcRow){           // rows above the screen are decoded and dropped
+      for(col=0; col<image->w; col=col+1){
+        indices[col] = rleNext(&s, image->bpp);
+      }
+      decoded = decoded + 1;
+    }
+    src = &indices[first];
+    rep = scale - (x0 - x)%scale;
+    for(col=x0; col<=x1; col=col+1){
+      writepixel(image->palette[*src]);
+      rep = rep - 1;
+      if(rep == 0){
+        src++;
+        rep = scale;
+      }
+    }
+  }
+}
+
+
 //------------ST7735_DrawCharS------------
 // Simple character draw function.  This is the same function from
 // Adafruit_GFX.c but adapted for this processor.  However, each call
@@ -1181,6 +2986,7 @@ void ST7735_DrawBitmap(int16_t x, int16_t y, const uint16_t *image, int16_t w, i
 void ST7735_DrawCharS(int16_t x, int16_t y, char c, int16_t textColor, int16_t bgColor, uint8_t size){
   uint8_t line; // vertical column of pixels of character in font
   int32_t i, j;
+  STAT_CALL(ST7735_PRIM_CHARS);
   if((x >= _width)            || // Clip right
      (y >= _height)           || // Clip bottom
      ((x + 5 * size - 1) < 0) || // Clip left
@@ -1228,6 +3034,7 @@ void ST7735_DrawCharS(int16_t x, int16_t y, char c, int16_t textColor, int16_t b
 void ST7735_DrawChar(int16_t x, int16_t y, char c, int16_t textColor, int16_t bgColor, uint8_t size){
   uint8_t line; // horizontal row of pixels of character
   int32_t col, row, i, j;// loop indices
+  STAT_CALL(ST7735_PRIM_CHAR);
   if(((x + 5*size - 1) >= _width)  || // Clip right
      ((y + 8*size - 1) >= _height) || // Clip bottom
      ((x + 5*size - 1) < 0)        || // Clip left
@@ -1263,10 +3070,117 @@ void ST7735_DrawChar(int16_t x, int16_t y, char c, int16_t textColor, int16_t bg
     line = line<<1;   // move up to the next row
   }
 }
+
+
+// Expand one font row (bits is its mask) of n characters into
+// 6*size*n pixels of a line buffer
+void static textRow(uint16_t *dst, const char *pt, uint32_t n, uint8_t bits,
+                    uint16_t textColor, uint16_t bgColor, uint8_t size) {
+  const uint8_t *glyph;
+  uint32_t i = 0, k, col, j;
+  for(k=0; k<n; k=k+1){
+    glyph = &Font[((uint8_t)pt[k])*5];
+    for(col=0; col<6; col=col+1){
+      uint16_t color = ((col < 5) && (glyph[col]&bits)) ? textColor : bgColor;
+      for(j=0; j<size; j=j+1){
+        dst[i] = color;
+        i = i + 1;
+      }
+    }
+  }
+}
+
+
+//------------ST7735_DrawText------------
+// String draw function that sends a whole run of characters through
+// one address window.  Each font row of the run is expanded into a
+// line buffer once and sent size times, so the command overhead is
+// paid once per string instead of once per font pixel.  Characters
+// are the 6x8 cells of ST7735_DrawCharS, enlarged by size.  Only the
+// characters that fit completely between the left and right edges are
+// printed; rows above or below the screen are clipped.  If the
+// background color is the same as the text color, no background is
+// printed and each horizontal run of set font pixels is one FillRect.
+// Requires (11 + 2*size*size*6*8*n) bytes of transmission for n characters (textColor != bgColor)
+// Input: x         horizontal position of the top left corner of the first character, columns from the left edge
+//        y         vertical position of the top left corner of the first character, rows from the top edge
+//        pt        pointer to a null terminated string to be printed
+//        textColor 16-bit color of the characters
+//        bgColor   16-bit color of the background
+//        size      number of pixels per character pixel (e.g. size==2 prints each pixel of font as 2x2 square)
+// Output: number of characters printed
+uint32_t ST7735_DrawText(int16_t x, int16_t y, const char *pt, int16_t textColor, int16_t bgColor, uint8_t size){
+  uint16_t *dst;
+  uint32_t n, w, i, k, col, reps;
+  int32_t cell, row, y0, y1, start;
+  uint8_t line, bits, buf = 0;
+  STAT_CALL(ST7735_PRIM_TEXT);
+  if(size == 0) size = 1;
+  cell = 6*size;
+  while(*pt && (x < 0)){                // skip characters that start left of the screen
+    pt++;
+    x = x + cell;
+  }
+  n = 0;
+  while(pt[n] && ((x + (int32_t)(n+1)*cell) <= _width)){
+    n++;
+  }
+  if((n == 0) || (y >= _height) || ((y + 8*size) <= 0)) return 0;
+
+  if(textColor == bgColor){             // transparent: horizontal spans of set pixels
+    for(row=0; row<8; row=row+1){
+      bits = 1<<row;
+      start = -1;
+      for(col=0; col<=6*n; col=col+1){  // one column past the end closes the last span
+        line = 0;
+        if((col < 6*n) && ((col%6) < 5)){
+          line = Font[((uint8_t)pt[col/6])*5 + col%6]&bits;
+        }
+        if(line && (start < 0)){
+          start = col;
+        } else if(!line && (start >= 0)){
+          ST7735_FillRect(x+start*size, y+row*size, (col-start)*size, size, textColor);
+          start = -1;
+        }
+      }
+    }
+    return n;
+  }
+
+  y0 = y;
+  y1 = y + 8*size - 1;
+  if(y0 < 0) y0 = 0;
+  if(y1 >= _height) y1 = _height - 1;
+  w = n*cell;
+  setAddrWindow(x, y0, x+w-1, y1);
+  row = y0;
+  while(row <= y1){
+    bits = 1<<((row - y)/size);         // font row of this screen row
+    reps = size - (row - y)%size;       // screen rows left in this font row
+    if(reps > (uint32_t)(y1 - row + 1)) reps = y1 - row + 1;
+    dst = LineBuffer[buf];
+    textRow(dst, pt, n, bits, textColor, bgColor, size);
+    for(k=0; k<reps; k=k+1){
+      if(w < DMA_MIN_PIXELS){           // too small to be worth a uDMA setup
+        for(i=0; i<w; i=i+1){
+          writepixel(dst[i]);
+        }
+      } else{
+        lineBufferWait();               // the other line buffer is done
+        dmaStart(dst, 0, 1, w);
+      }
+    }
+    buf = buf^1;
+    row = row + reps;
+  }
+  return n;
+}
+
+
 //------------ST7735_DrawString------------
 // String draw function.
 // 16 rows (0 to 15) and 21 characters (0 to 20)
-// Requires (11 + size*size*6*8) bytes of transmission for each character
+// Requires (11 + 2*6*8*n) bytes of transmission for n characters
 // Input: x         columns from the left edge (0 to 20)
 //        y         rows from the top edge (0 to 15)
 //        pt        pointer to a null terminated string to be printed
@@ -1274,36 +3188,257 @@ void ST7735_DrawChar(int16_t x, int16_t y, char c, int16_t textColor, int16_t bg
 // bgColor is Black and size is 1
 // Output: number of characters printed
 uint32_t ST7735_DrawString(uint16_t x, uint16_t y, char *pt, int16_t textColor){
-  uint32_t count = 0;
-  if(y>15) return 0;
-  while(*pt){
-    ST7735_DrawCharS(x*6, y*10, *pt, textColor, ST7735_BLACK, 1);
-    pt++;
-    x = x+1;
-    if(x>20) return count;  // number of characters printed
-    count++;
+  if((y>15) || (x>20)) return 0;
+  return ST7735_DrawText(x*6, y*10, pt, textColor, ST7735_BLACK, 1);  // number of characters printed
+}
+
+
+//------------ST7735_UpdateTextField------------
+// Show text in a text field.  Only the cells whose character differs
+// from the one they show are repainted, each with ST7735_DrawChar();
+// cells after the end of text are cleared (a space), characters past
+// the last cell are cut off.  Changing "60" to "61" sends one cell.
+// Requires (11 + size*size*6*8*2) bytes of transmission per changed cell
+// Input: f    text field
+//        text pointer to a null terminated string
+// Output: number of cells repainted
+uint32_t ST7735_UpdateTextField(ST7735_TextField *f, const char *text){
+  uint32_t i, n = 0;
+  uint32_t len = (f->len < ST7735_FIELD_MAX) ? f->len : ST7735_FIELD_MAX; // cells in shown[]
+  char c;
+  for(i=0; i<len; i=i+1){
+    c = ' ';                            // padding after the end of text
+    if(*text){
+      c = *text;
+      text = text + 1;
+    }
+    if(c != f->shown[i]){
+      ST7735_DrawChar(f->x + i*6*f->size, f->y, c, f->color, f->bgColor, f->size);
+      f->shown[i] = c;
+      n = n + 1;
+    }
   }
-  return count;  // number of characters printed
+  return n;
 }
 
-//-----------------------fillmessage-----------------------
-// Output a 32-bit number in unsigned decimal format
-// Input: 32-bit number to be transferred
+
+//------------ST7735_SetTextFieldShown------------
+// Record what the cells of a text field show without drawing, for
+// example after a display list or a screen image drew them.  With
+// text 0 every cell is unknown and the next ST7735_UpdateTextField()
+// repaints them all.
+// Input: f    text field
+//        text pointer to a null terminated string, or 0
 // Output: none
-// Variable format 1-10 digits with no space before or after
-char Message[12];
-uint32_t Messageindex;
+void ST7735_SetTextFieldShown(ST7735_TextField *f, const char *text){
+  uint32_t i;
+  uint32_t len = (f->len < ST7735_FIELD_MAX) ? f->len : ST7735_FIELD_MAX;
+  for(i=0; i<len; i=i+1){
+    f->shown[i] = ' ';
+    if(text == 0){
+      f->shown[i] = 0;
+    } else if(*text){
+      f->shown[i] = *text;
+      text = text + 1;
+    }
+  }
+}
 
-void fillmessage(uint32_t n){
-// This function uses recursion to convert decimal number
-//   of unspecified length as an ASCII string
-  if(n >= 10){
-    fillmessage(n/10);
-    n = n%10;
+
+// *************** Asynchronous draw queue ********************
+// ST7735_Enqueue() copies a draw operation into a ring and returns;
+// SSI0_Handler takes the operations out one after the other as each
+// uDMA stream ends, so large redraws go out while the main program
+// keeps running.  A fill or a top-down pixel block is one stream,
+// text and bitmaps one stream per row.  Only the address window is
+// sent from the interrupt by the CPU, at most 11 bytes.  The ring has
+// one producer (the main program) and one consumer (SSI0_Handler).
+// Strings and pixels are read when the operation is sent, so they must
+// not change until ST7735_QueueWait().  Every other driver function
+// first waits for the queue to empty (setAddrWindow and writecommand
+// wait while the uDMA owns SSI0), so the two can be mixed.  Queued
+// operations go straight to the LCD, never into the framebuffer or a
+// band.
+static ST7735_DrawOp Queue[ST7735_QUEUE_SIZE];
+static volatile uint32_t QueuePutI;     // written only by ST7735_Enqueue
+static volatile uint32_t QueueGetI;     // written only by queueStep
+static ST7735_DrawOp QueueOp;           // operation being sent
+static int16_t QueueRow, QueueLast;     // next and last row of a text or bitmap operation
+static uint8_t QueueReps;               // text: rows still to send from QueueLine
+static const uint16_t *QueueSrc;        // bitmap: next row in memory
+static uint16_t QueueLine[ST7735_TFTHEIGHT]; // text row being sent
+
+// Set up the window of an operation; 0 if nothing of it is on the screen
+int static queueStart(ST7735_DrawOp *op) {
+  int16_t x = op->x, y = op->y, w = op->w, h = op->h;
+  uint8_t size;
+  const char *pt;
+  switch(op->op){
+    case ST7735_OP_FILLRECT:            // clipped as by ST7735_FillRect
+      if((x >= _width) || (y >= _height)) return 0;
+      if(x < 0){ w = w + x; x = 0; }
+      if(y < 0){ h = h + y; y = 0; }
+      if((x + w - 1) >= _width)  w = _width  - x;
+      if((y + h - 1) >= _height) h = _height - y;
+      if((w <= 0) || (h <= 0)) return 0;
+      setAddrWindow(x, y, x+w-1, y+h-1);
+      dmaStart(0, op->color, 0, w*h);
+      return 1;
+    case ST7735_OP_PIXELS:              // fully on the screen only
+      if((x < 0) || (y < 0) || (w <= 0) || (h <= 0) ||
+         ((x + w) > _width) || ((y + h) > _height)) return 0;
+      setAddrWindow(x, y, x+w-1, y+h-1);
+      dmaStart(op->data, 0, 1, w*h);
+      return 1;
+    case ST7735_OP_BITMAP:              // y is the bottom row; fully on the screen only
+      if((x < 0) || ((y - h + 1) < 0) || (w <= 0) || (h <= 0) ||
+         ((x + w) > _width) || (y >= _height)) return 0;
+      setAddrWindow(x, y-h+1, x+w-1, y);
+      QueueSrc = (const uint16_t *)op->data + w*(h - 1); // top row is stored last
+      QueueRow = 0;
+      QueueLast = h - 1;
+      return 1;
+    case ST7735_OP_TEXT:                // clipped as by ST7735_DrawText
+      size = op->size ? op->size : 1;
+      pt = (const char *)op->data;
+      while(*pt && (x < 0)){
+        pt++;
+        x = x + 6*size;
+      }
+      w = 0;                            // characters that fit
+      while(pt[w] && ((x + (w+1)*6*size) <= _width)){
+        w++;
+      }
+      if((w == 0) || (y >= _height) || ((y + 8*size) <= 0)) return 0;
+      op->x = x;
+      op->w = w;
+      op->size = size;
+      op->data = pt;
+      QueueRow = (y < 0) ? 0 : y;
+      QueueLast = y + 8*size - 1;
+      if(QueueLast >= _height) QueueLast = _height - 1;
+      QueueReps = 0;
+      setAddrWindow(x, QueueRow, x+w*6*size-1, QueueLast);
+      return 1;
   }
-  Message[Messageindex] = (n+'0'); /* n is between 0 and 9 */
-  if(Messageindex<11)Messageindex++;
+  return 0;
 }
+
+// Start the next uDMA stream of the queue, or stop the queue when it
+// is empty.  Runs in SSI0_Handler, or through queueResume().
+void static queueStep(void) {
+  ST7735_DrawOp *op = &QueueOp;
+  STAT_ENTER(ST7735_PRIM_QUEUE);        // the main program may be in another primitive
+#if ST7735_FRAMEBUFFER
+  uint8_t active = FBActive;
+  FBActive = 0;                         // the main program may be drawing into the framebuffer
+#else
+  uint8_t active = BandActive;
+  BandActive = 0;                       // or into a band
+#endif
+  while(1){
+    if((op->op == ST7735_OP_BITMAP) && (QueueRow <= QueueLast)){
+      dmaStart(QueueSrc, 0, 1, op->w);
+      QueueSrc = QueueSrc - op->w;
+      QueueRow = QueueRow + 1;
+      break;
+    }
+    if((op->op == ST7735_OP_TEXT) && (QueueRow <= QueueLast)){
+      if(QueueReps == 0){               // first screen row of a font row
+        uint8_t fontRow = (QueueRow - op->y)/op->size;
+        textRow(QueueLine, op->data, op->w, 1<<fontRow, op->color, op->bgColor, op->size);
+        QueueReps = op->size - (QueueRow - op->y)%op->size;
+      }
+      dmaStart(QueueLine, 0, 1, op->w*6*op->size);
+      QueueReps = QueueReps - 1;
+      QueueRow = QueueRow + 1;
+      break;
+    }
+    if(QueueGetI == QueuePutI){
+      QueueRunning = 0;
+      break;
+    }
+    *op = Queue[QueueGetI&(ST7735_QUEUE_SIZE-1)];
+    QueueGetI = QueueGetI + 1;          // free the entry after it is copied
+    QueueRow = 1;
+    QueueLast = 0;                      // no rows unless queueStart sets them
+    if(queueStart(op) && ((op->op == ST7735_OP_FILLRECT) || (op->op == ST7735_OP_PIXELS))){
+      break;                            // one stream for the whole operation
+    }
+  }
+#if ST7735_FRAMEBUFFER
+  FBActive = active;
+#else
+  BandActive = active;
+#endif
+  STAT_LEAVE();
+}
+
+
+// Start a queue that is running but has nothing on the wire, unless a
+// stream (or the init) still holds panel 0; its end then starts it.
+// Runs in ST7735_Enqueue with the SSI0 and Timer2A interrupts masked,
+// or in Timer2A_Handler when the init of panel 0 is done.  Panel is
+// panel 0.
+void static queueResume(void) {
+#if ST7735_HOST
+  while(QueueRunning && !DMABusy) queueStep(); // each stream is sent as it starts
+#else
+  if(!DMABusy) queueStep();             // else SSI0_Handler starts it after the current stream
+#endif
+}
+
+
+//------------ST7735_Enqueue------------
+// Queue a draw operation (ST7735_OP_FILLRECT, ST7735_OP_TEXT,
+// ST7735_OP_BITMAP or ST7735_OP_PIXELS) to be sent in the background.
+// The function returns at once; if the queue was idle the address
+// window of the operation is sent first.  A full queue is reported
+// instead of waited for, so the caller can keep doing other work.
+// Bitmaps and pixel blocks must be fully on the screen; text in the
+// background color (transparent) and RLE images cannot be queued.
+// The queue always sends to panel 0.  Call only from the main program.
+// Input: op pointer to the operation, copied into the queue
+// Output: 1 if queued, 0 if the queue is full, -1 if op cannot be queued
+int ST7735_Enqueue(const ST7735_DrawOp *op) {
+  if((op->op == ST7735_OP_RLEIMAGE) || (op->op > ST7735_OP_PIXELS) ||
+     ((op->op == ST7735_OP_TEXT) && (op->color == op->bgColor))) return -1;
+  if(QueuePutI - QueueGetI >= ST7735_QUEUE_SIZE) return 0;
+  Queue[QueuePutI&(ST7735_QUEUE_SIZE-1)] = *op;
+  uint32_t irqs = NVIC_EN0_R&((1<<7)|(1<<INIT_TIMER_IRQ)); // SSI0 and Timer2A, if on
+  NVIC_DIS0_R = irqs;                   // their handlers must not start or stop the queue meanwhile
+  QueuePutI = QueuePutI + 1;            // publish after the entry is written
+  if(!QueueRunning){
+    PanelState *caller = Panel;
+    Panel = &Panels[0];                 // the queue sends to panel 0
+    QueueRunning = 1;
+    queueResume();
+    Panel = caller;
+  }
+  NVIC_EN0_R = irqs;
+  return 1;
+}
+
+
+//------------ST7735_QueueFree------------
+// Number of operations that can be queued without ST7735_Enqueue
+// reporting a full queue.
+// Input: none
+// Output: free entries, 0 to ST7735_QUEUE_SIZE
+uint32_t ST7735_QueueFree(void) {
+  return ST7735_QUEUE_SIZE - (QueuePutI - QueueGetI);
+}
+
+
+//------------ST7735_QueueWait------------
+// Fence: wait until every queued operation has been sent, after
+// which their strings and pixels may be changed.
+// Input: none
+// Output: none
+void ST7735_QueueWait(void) {
+  while(QueueRunning || DMABusy){};
+}
+
 //********ST7735_SetCursor*****************
 // Move the cursor to the desired X- and Y-position.  The
 // next character will be printed here.  X=0 is the leftmost
@@ -1325,12 +3460,12 @@ void ST7735_SetCursor(uint32_t newX, uint32_t newY){
 // Input: 32-bit number to be transferred
 // Output: none
 // Variable format 1-10 digits with no space before or after
+// One address window for all the digits (ST7735_DrawText)
 void ST7735_OutUDec(uint32_t n){
-  Messageindex = 0;
-  fillmessage(n);
-  Message[Messageindex] = 0; // terminate
-  ST7735_DrawString(StX,StY,Message,StTextColor);
-  StX = StX+Messageindex;
+  char message[FORMAT_SIZE];
+  uint32_t len = Format_UDec(message, n, 0);
+  ST7735_DrawString(StX,StY,message,StTextColor);
+  StX = StX+len;
   if(StX>20){
     StX = 20;
     ST7735_DrawCharS(StX*6,StY*10,'*',ST7735_RED,ST7735_BLACK, 1);
@@ -1349,15 +3484,9 @@ void ST7735_OutUDec(uint32_t n){
 #define MADCTL_BGR 0x08
 #define MADCTL_MH  0x04
 
-//------------ST7735_SetRotation------------
-// Change the image rotation.
-// Requires 2 bytes of transmission
-// Input: m new rotation value (0 to 3)
-// Output: none
-void ST7735_SetRotation(uint8_t m) {
-
+// Send MADCTL for Rotation and TabColor
+void static sendMADCTL(void) {
   writecommand(ST7735_MADCTL);
-  Rotation = m % 4; // can't be higher than 3
   switch (Rotation) {
    case 0:
      if (TabColor == INITR_BLACKTAB) {
@@ -1365,8 +3494,6 @@ void ST7735_SetRotation(uint8_t m) {
      } else {
        writedata(MADCTL_MX | MADCTL_MY | MADCTL_BGR);
      }
-     _width  = ST7735_TFTWIDTH;
-     _height = ST7735_TFTHEIGHT;
      break;
    case 1:
      if (TabColor == INITR_BLACKTAB) {
@@ -1374,8 +3501,6 @@ void ST7735_SetRotation(uint8_t m) {
      } else {
        writedata(MADCTL_MY | MADCTL_MV | MADCTL_BGR);
      }
-     _width  = ST7735_TFTHEIGHT;
-     _height = ST7735_TFTWIDTH;
      break;
   case 2:
      if (TabColor == INITR_BLACKTAB) {
@@ -1383,8 +3508,6 @@ void ST7735_SetRotation(uint8_t m) {
      } else {
        writedata(MADCTL_BGR);
      }
-     _width  = ST7735_TFTWIDTH;
-     _height = ST7735_TFTHEIGHT;
     break;
    case 3:
      if (TabColor == INITR_BLACKTAB) {
@@ -1392,12 +3515,42 @@ void ST7735_SetRotation(uint8_t m) {
      } else {
        writedata(MADCTL_MX | MADCTL_MV | MADCTL_BGR);
      }
-     _width  = ST7735_TFTHEIGHT;
-     _height = ST7735_TFTWIDTH;
      break;
   }
 }
 
+//------------ST7735_SetRotation------------
+// Change the image rotation.  When the driver is built for a fixed
+// rotation (ST7735_FIXED_ROTATION) m is ignored and the fixed
+// rotation is sent again.
+// Requires 2 bytes of transmission
+// Input: m new rotation value (0 to 3)
+// Output: none
+void ST7735_SetRotation(uint8_t m) {
+
+#if ST7735_FRAMEBUFFER
+  uint8_t active = FBActive;
+  FBActive = 0;                         // MADCTL always goes straight to the LCD
+#endif
+#if ST7735_FIXED
+  (void)m;
+#else
+  Rotation = m % 4; // can't be higher than 3
+#endif
+  sendMADCTL();
+#if !ST7735_FIXED
+  _width  = (Rotation & 1) ? ST7735_TFTHEIGHT : ST7735_TFTWIDTH;
+  _height = (Rotation & 1) ? ST7735_TFTWIDTH  : ST7735_TFTHEIGHT;
+#endif
+#if ST7735_FRAMEBUFFER
+  FBActive = active;
+  if(FBReady){                          // rows changed length, resend everything
+    NumDirty = 0;
+    fbMarkDirty(0, 0, _width-1, _height-1);
+  }
+#endif
+}
+
 
 //------------ST7735_InvertDisplay------------
 // Send the command to invert all of the colors.
@@ -1411,6 +3564,130 @@ void ST7735_InvertDisplay(int i) {
     writecommand(ST7735_INVOFF);
   }
 }
+
+
+// Vertical scrolling
+// VSCRDEF and VSCSAD count frame memory rows in the order the panel
+// refreshes them, which MADCTL does not change, while MADCTL MY
+// reverses the rows that RASET addresses.  In rotation 0 (MY set,
+// "bottom to top refresh") screen row y is frame memory row
+// 161 - (y + RowStart), so the panel's top fixed area is the bottom
+// of the picture and its scrolling goes the other way; in rotation 2
+// screen row y is memory row y + RowStart.  The functions below take
+// screen rows in both portrait rotations.  In rotations 1 and 3 the
+// panel rows are the columns of the picture: top and bottom count
+// columns as in rotation 2, and the picture moves sideways.
+#define ST7735_FRAMEROWS 162            // rows of frame memory in the controller
+#define SCROLL_MIRRORED (Rotation == 0) // frame memory rows run bottom to top of the screen
+static uint16_t ScrollTop;              // first scrolling row (frame memory)
+static uint16_t ScrollRows = ST7735_TFTHEIGHT; // height of the scrolling area
+
+//------------ST7735_SetScrollArea------------
+// Split the screen into a fixed top area, a vertically scrolling
+// area and a fixed bottom area, and show the scrolling area
+// unscrolled.  Nothing is redrawn: the scrolling area wraps around
+// the frame memory it already holds.
+// Requires 10 bytes of transmission
+// Input: top    number of fixed rows at the top of the screen
+//        bottom number of fixed rows at the bottom of the screen
+// Output: none
+void ST7735_SetScrollArea(uint16_t top, uint16_t bottom) {
+  uint16_t bfa;
+  if(top + bottom >= ST7735_TFTHEIGHT) return;
+  if(SCROLL_MIRRORED){                  // the panel's top area is the screen's bottom
+    ScrollTop = ST7735_FRAMEROWS - ST7735_TFTHEIGHT - RowStart + bottom;
+  } else{
+    ScrollTop = top + RowStart;
+  }
+  ScrollRows = ST7735_TFTHEIGHT - top - bottom;
+  bfa = ST7735_FRAMEROWS - ScrollTop - ScrollRows;
+  writecommand(ST7735_VSCRDEF);
+  writedata(ScrollTop>>8);
+  writedata(ScrollTop);                 // TFA
+  writedata(ScrollRows>>8);
+  writedata(ScrollRows);                // VSA
+  writedata(bfa>>8);
+  writedata(bfa);                       // BFA
+  ST7735_Scroll(0);
+}
+
+
+//------------ST7735_Scroll------------
+// Scroll the scrolling area set by ST7735_SetScrollArea().  The
+// row drawn at the top of the area moves down by offset rows; rows
+// pushed off the bottom come back in at the top.  ST7735_Scroll(0)
+// after ST7735_SetScrollArea(0, 0) is the normal, unscrolled screen.
+// Requires 3 bytes of transmission
+// Input: offset number of rows to move the picture down, any value
+// Output: none
+void ST7735_Scroll(uint16_t offset) {
+  uint16_t vsp;
+  offset = offset%ScrollRows;
+  if(SCROLL_MIRRORED){                  // down the screen is up the frame memory
+    vsp = ScrollTop + offset;
+  } else{
+    vsp = ScrollTop + (offset ? (ScrollRows - offset) : 0); // memory row shown first
+  }
+  writecommand(ST7735_VSCSAD);
+  writedata(vsp>>8);
+  writedata(vsp);
+}
+
+
+// Power saving
+// In idle mode the panel shows only 8 colors (the top bit of each
+// of red, green and blue) and runs slower.  Sleep-in turns the panel
+// and its booster off but keeps the frame memory, so nothing has
+// to be redrawn after ST7735_Wake().
+static const uint8_t
+  Sleepcmd[] = {                  // Enter sleep
+    2,                            // 2 commands in list:
+    ST7735_DISPOFF,   0,          //  1: Display off, no args, no delay
+    ST7735_SLPIN  ,   DELAY,      //  2: Sleep in, no args, w/delay
+      5 },                        //     5 ms before the next command
+  Wakecmd[] = {                   // Leave sleep
+    2,                            // 2 commands in list:
+    ST7735_SLPOUT ,   DELAY,      //  1: Out of sleep mode, no args, w/delay
+      120,                        //     120 ms for the booster to settle
+    ST7735_DISPON ,   DELAY,      //  2: Main screen turn on, no args, w/delay
+      10 };                       //     10 ms delay
+
+
+//------------ST7735_SetIdleMode------------
+// Turn the panel's 8-color idle mode on or off.
+// Requires 1 byte of transmission
+// Input: enable non-zero for idle mode, 0 for full color
+// Output: none
+void ST7735_SetIdleMode(int enable) {
+  if(enable){
+    writecommand(ST7735_IDMON);
+  } else{
+    writecommand(ST7735_IDMOFF);
+  }
+}
+
+
+//------------ST7735_Sleep------------
+// Turn the display off and put the LCD controller to sleep.  Waits
+// until the commands are out, so the SSI may be clock gated afterwards.
+// Call ST7735_Wake() before drawing again.
+// Requires 2 bytes of transmission
+// Input: none
+// Output: none
+void ST7735_Sleep(void) {
+  commandList(Sleepcmd);
+}
+
+
+//------------ST7735_Wake------------
+// Wake the LCD controller and turn the display back on.  Blocks for
+// about 130 ms while the panel powers up.
+// Requires 2 bytes of transmission
+// Input: none
+// Output: none
+void ST7735_Wake(void) {
+  commandList(Wakecmd);
+}
 // graphics routines
 // y coordinates 0 to 31 used for labels and messages
 // y coordinates 32 to 159  128 pixels high
@@ -1418,6 +3695,26 @@ void ST7735_InvertDisplay(int i) {
 
 int32_t Ymax,Ymin,X;        // X goes from 0 to 127
 int32_t Yrange; //YrangeDiv2;
+// The samples are scaled with a reciprocal computed once by
+// ST7735_PlotClear(): PlotScale = 127*2^24/Yrange, so a sample's
+// row offset is one 32x32->64 multiply and a shift instead of a
+// divide.  The result equals 127*(Ymax-y)/Yrange for ranges up to
+// 4096 and is within Yrange/2^24 rows of it above that.
+#define PLOT_TOP    32              // first row of the plot area
+#define PLOT_ROWS   128             // rows 32 to 159
+#define PLOT_SHIFT  24
+static uint32_t PlotScale = ((uint32_t)127<<PLOT_SHIFT); // Yrange of 1 until ST7735_PlotClear()
+static uint16_t PlotColor = ST7735_BLUE;   // points, lines and bars
+static uint16_t PlotBgColor = 0xE73C;      // ST7735_Color565(228,228,228), light grey
+
+// Offset of y below the top of the plot area, 0 (Ymax) to 127 (Ymin)
+static uint32_t plotOffset(int32_t y){
+  uint32_t j;
+  if(y<Ymin) y=Ymin;
+  if(y>Ymax) y=Ymax;
+  j = ((uint64_t)(uint32_t)(Ymax-y)*PlotScale)>>PLOT_SHIFT;
+  return (j > PLOT_ROWS-1) ? (PLOT_ROWS-1) : j;
+}
 
 // *************** ST7735_PlotClear ********************
 // Clear the graphics buffer, set X coordinate to 0
@@ -1425,98 +3722,85 @@ int32_t Yrange; //YrangeDiv2;
 // Inputs: ymin and ymax are range of the plot
 // Outputs: none
 void ST7735_PlotClear(int32_t ymin, int32_t ymax){
-  ST7735_FillRect(0, 32, 128, 128, ST7735_Color565(228,228,228)); // light grey
+  ST7735_FillRect(0, PLOT_TOP, 128, PLOT_ROWS, PlotBgColor);
   if(ymax>ymin){
     Ymax = ymax;
     Ymin = ymin;
-    Yrange = ymax-ymin;
   } else{
     Ymax = ymin;
     Ymin = ymax;
-    Yrange = ymax-ymin;
   }
+  Yrange = Ymax-Ymin;
+  if(Yrange < 1) Yrange = 1;           // one value: everything on the top row
+  PlotScale = ((uint32_t)127<<PLOT_SHIFT)/(uint32_t)Yrange;
+  if(((uint32_t)127<<PLOT_SHIFT)%(uint32_t)Yrange) PlotScale++; // round up, see above
   //YrangeDiv2 = Yrange/2;
   X = 0;
 }
-
+// *************** ST7735_PlotSetColors ********************
+// Set the colors used by all the plot functions: points, lines and
+// bars are drawn in color (ST7735_PlotPoint, ST7735_PlotLine,
+// ST7735_PlotPoints, ST7735_PlotBar, ST7735_PlotdBfs and the
+// ST7735_PlotStream trace), ST7735_PlotClear and ST7735_PlotNextErase
+// fill with bgColor
+// Inputs: color   16-bit color of points and lines (default blue)
+//         bgColor 16-bit color of the plot background (default light grey)
+// Outputs: none
+void ST7735_PlotSetColors(uint16_t color, uint16_t bgColor){
+  PlotColor = color;
+  PlotBgColor = bgColor;
+}
 // *************** ST7735_PlotPoint ********************
 // Used in the voltage versus time plot, plot one point at y
 // It does output to display
+// The 2 by 2 point is one address window
 // Inputs: y is the y coordinate of the point plotted
 // Outputs: none
 void ST7735_PlotPoint(int32_t y){int32_t j;
-  if(y<Ymin) y=Ymin;
-  if(y>Ymax) y=Ymax;
   // X goes from 0 to 127
   // j goes from 159 to 32
   // y=Ymax maps to j=32
   // y=Ymin maps to j=159
-  j = 32+(127*(Ymax-y))/Yrange;
-  if(j<32) j = 32;
-  if(j>159) j = 159;
-  ST7735_DrawPixel(X,   j,   ST7735_BLUE);
-  ST7735_DrawPixel(X+1, j,   ST7735_BLUE);
-  ST7735_DrawPixel(X,   j+1, ST7735_BLUE);
-  ST7735_DrawPixel(X+1, j+1, ST7735_BLUE);
+  j = PLOT_TOP + plotOffset(y);
+  ST7735_FillRect(X, j, 2, 2, PlotColor); // row 160 is clipped
 }
 // *************** ST7735_PlotLine ********************
 // Used in the voltage versus time plot, plot line to new point
 // It does output to display
+// The 2 pixel wide segment from the last point is one address window
 // Inputs: y is the y coordinate of the point plotted
 // Outputs: none
 int32_t lastj=0;
-void ST7735_PlotLine(int32_t y){int32_t i,j;
-  if(y<Ymin) y=Ymin;
-  if(y>Ymax) y=Ymax;
+void ST7735_PlotLine(int32_t y){int32_t j;
   // X goes from 0 to 127
   // j goes from 159 to 32
   // y=Ymax maps to j=32
   // y=Ymin maps to j=159
-  j = 32+(127*(Ymax-y))/Yrange;
-  if(j < 32) j = 32;
-  if(j > 159) j = 159;
+  j = PLOT_TOP + plotOffset(y);
   if(lastj < 32) lastj = j;
   if(lastj > 159) lastj = j;
   if(lastj < j){
-    for(i = lastj+1; i<=j ; i++){
-      ST7735_DrawPixel(X,   i,   ST7735_BLUE) ;
-      ST7735_DrawPixel(X+1, i,   ST7735_BLUE) ;
-    }
+    ST7735_FillRect(X, lastj+1, 2, j-lastj, PlotColor);
   }else if(lastj > j){
-    for(i = j; i<lastj ; i++){
-      ST7735_DrawPixel(X,   i,   ST7735_BLUE) ;
-      ST7735_DrawPixel(X+1, i,   ST7735_BLUE) ;
-    }
+    ST7735_FillRect(X, j, 2, lastj-j, PlotColor);
   }else{
-    ST7735_DrawPixel(X,   j,   ST7735_BLUE) ;
-    ST7735_DrawPixel(X+1, j,   ST7735_BLUE) ;
+    ST7735_FillRect(X, j, 2, 1, PlotColor);
   }
   lastj = j;
 }
-
 // *************** ST7735_PlotPoints ********************
 // Used in the voltage versus time plot, plot two points at y1, y2
 // It does output to display
 // Inputs: y1 is the y coordinate of the first point plotted
 //         y2 is the y coordinate of the second point plotted
 // Outputs: none
-void ST7735_PlotPoints(int32_t y1,int32_t y2){int32_t j;
-  if(y1<Ymin) y1=Ymin;
-  if(y1>Ymax) y1=Ymax;
+void ST7735_PlotPoints(int32_t y1,int32_t y2){
   // X goes from 0 to 127
   // j goes from 159 to 32
   // y=Ymax maps to j=32
   // y=Ymin maps to j=159
-  j = 32+(127*(Ymax-y1))/Yrange;
-  if(j<32) j = 32;
-  if(j>159) j = 159;
-  ST7735_DrawPixel(X, j, ST7735_BLUE);
-  if(y2<Ymin) y2=Ymin;
-  if(y2>Ymax) y2=Ymax;
-  j = 32+(127*(Ymax-y2))/Yrange;
-  if(j<32) j = 32;
-  if(j>159) j = 159;
-  ST7735_DrawPixel(X, j, ST7735_BLACK);
+  ST7735_DrawPixel(X, PLOT_TOP + plotOffset(y1), PlotColor);
+  ST7735_DrawPixel(X, PLOT_TOP + plotOffset(y2), PlotColor);
 }
 // *************** ST7735_PlotBar ********************
 // Used in the voltage versus time bar, plot one bar at y
@@ -1525,17 +3809,13 @@ void ST7735_PlotPoints(int32_t y1,int32_t y2){int32_t j;
 // Outputs: none
 void ST7735_PlotBar(int32_t y){
 int32_t j;
-  if(y<Ymin) y=Ymin;
-  if(y>Ymax) y=Ymax;
   // X goes from 0 to 127
   // j goes from 159 to 32
   // y=Ymax maps to j=32
   // y=Ymin maps to j=159
-  j = 32+(127*(Ymax-y))/Yrange;
-  ST7735_DrawFastVLine(X, j, 159-j, ST7735_BLACK);
-
+  j = PLOT_TOP + plotOffset(y);
+  ST7735_DrawFastVLine(X, j, 159-j, PlotColor);
 }
-
 // full scaled defined as 3V
 // Input is 0 to 511, 0 => 159 and 511 => 32
 uint8_t const dBfs[512]={
@@ -1581,7 +3861,7 @@ int32_t j;
   // y=511 maps to j=32
   // y=0 maps to j=159
   j = dBfs[y];
-  ST7735_DrawFastVLine(X, j, 159-j, ST7735_BLACK);
+  ST7735_DrawFastVLine(X, j, 159-j, PlotColor);
 
 }
 
@@ -1611,7 +3891,7 @@ void ST7735_PlotNextErase(void){
   } else{
     X++;
   }
-  ST7735_DrawFastVLine(X,32,128,ST7735_Color565(228,228,228));
+  ST7735_DrawFastVLine(X,32,128,PlotBgColor);
 }
 
 // Used in all the plots to write buffer to LCD
@@ -1657,6 +3937,123 @@ void ST7735_PlotNextErase(void){
 //        ST7735_PlotNext();
 //    }   // called 128 times
 
+// *************** Streaming plot ********************
+// History chart for sensor data arriving faster than it can be
+// drawn (kHz rates).  ST7735_PlotStream() only scales the sample
+// and keeps the lowest and highest value of the current column;
+// every N samples the column is drawn as one 128 pixel window:
+// background, then the span from the lowest to the highest value
+// (which starts at the last value of the previous column, so the
+// trace stays connected).  The window is streamed by the uDMA, so
+// the caller goes back to sampling at once.  The spans of the last
+// 128 columns are kept in a ring buffer for ST7735_PlotStreamRedraw().
+//   sweep  time runs left to right over the plot area (rows 32-159)
+//          and wraps around, like ST7735_PlotNext(); value up
+//   scroll time runs down: the newest row is added at the top of
+//          rows 32-159 and the older ones move down with hardware
+//          scrolling (rotation 0 only, see ST7735_SetScrollArea);
+//          value to the right
+#define STREAM_EMPTY 0xFF               // Stream[].lo of a slot never drawn
+typedef struct {
+  uint8_t lo, hi;                       // span of one column, plot offsets 0 to 127
+} StreamSpan;
+static StreamSpan Stream[PLOT_ROWS];    // by column (sweep) or frame memory row (scroll)
+static uint8_t StreamLo, StreamHi, StreamLast; // current column so far
+static uint16_t StreamCount, StreamN;   // samples in the current column, samples per column
+static uint8_t StreamSlot;              // where the current column goes
+static uint8_t StreamScroll;            // non-zero for scroll mode
+static uint16_t StreamOffset;           // hardware scroll offset in scroll mode
+
+// Draw the span of one slot through a line buffer and the uDMA
+static void streamDraw(uint8_t slot){
+  uint16_t *dst = LineBuffer[0];
+  uint32_t i, lo = Stream[slot].lo, hi = Stream[slot].hi;
+  lineBufferWait();                     // the previous column is out
+  for(i=0; i<PLOT_ROWS; i=i+1){
+    dst[i] = PlotBgColor;
+  }
+  if(lo != STREAM_EMPTY){
+    for(i=lo; i<=hi; i=i+1){
+      dst[StreamScroll ? (PLOT_ROWS-1-i) : i] = PlotColor;
+    }
+  }
+  if(StreamScroll){
+    setAddrWindow(0, PLOT_TOP+slot, PLOT_ROWS-1, PLOT_TOP+slot);
+  } else{
+    setAddrWindow(slot, PLOT_TOP, slot, PLOT_TOP+PLOT_ROWS-1);
+  }
+  dmaStart(dst, 0, 1, PLOT_ROWS);
+}
+
+// *************** ST7735_PlotStreamInit ********************
+// Clear the plot area and start a streaming plot
+// Inputs: ymin and ymax are range of the plot
+//         samplesPerColumn number of ST7735_PlotStream calls per column (0 is treated as 1)
+//         scroll 0 for sweep mode, 1 for hardware scroll mode
+// Outputs: none
+void ST7735_PlotStreamInit(int32_t ymin, int32_t ymax, uint16_t samplesPerColumn, int scroll){
+  uint32_t i;
+  ST7735_PlotClear(ymin, ymax);         // sets the scale
+  for(i=0; i<PLOT_ROWS; i=i+1){
+    Stream[i].lo = STREAM_EMPTY;
+  }
+  StreamN = samplesPerColumn ? samplesPerColumn : 1;
+  StreamCount = 0;
+  StreamScroll = (scroll != 0);
+  StreamOffset = 0;
+  StreamSlot = 0;
+  StreamLast = STREAM_EMPTY;
+  if(StreamScroll){
+    ST7735_SetScrollArea(PLOT_TOP, ST7735_TFTHEIGHT-PLOT_TOP-PLOT_ROWS);
+  }
+}
+
+// *************** ST7735_PlotStream ********************
+// Add one sample to the streaming plot; every samplesPerColumn
+// samples one column is drawn
+// Inputs: y is the sample
+// Outputs: none
+void ST7735_PlotStream(int32_t y){
+  uint8_t j = plotOffset(y);
+  if(StreamCount == 0){                 // first sample of a column
+    if(StreamLast == STREAM_EMPTY) StreamLast = j;
+    StreamLo = StreamHi = StreamLast;
+  }
+  if(j < StreamLo) StreamLo = j;
+  if(j > StreamHi) StreamHi = j;
+  StreamLast = j;
+  StreamCount = StreamCount + 1;
+  if(StreamCount < StreamN) return;
+  StreamCount = 0;
+  if(StreamScroll){                     // the oldest row becomes the top row
+    StreamOffset = StreamOffset + 1;
+    StreamSlot = (PLOT_ROWS - StreamOffset%PLOT_ROWS)%PLOT_ROWS;
+  }
+  Stream[StreamSlot].lo = StreamLo;
+  Stream[StreamSlot].hi = StreamHi;
+  streamDraw(StreamSlot);
+  if(StreamScroll){
+    ST7735_Scroll(StreamOffset);        // 3 bytes move the whole history
+  } else{
+    StreamSlot = (StreamSlot + 1)%PLOT_ROWS;
+  }
+}
+
+// *************** ST7735_PlotStreamRedraw ********************
+// Draw the whole history again from the ring buffer, for example
+// after another screen was shown over the plot area
+// Inputs: none
+// Outputs: none
+void ST7735_PlotStreamRedraw(void){
+  uint32_t i;
+  if(StreamScroll){
+    ST7735_SetScrollArea(PLOT_TOP, ST7735_TFTHEIGHT-PLOT_TOP-PLOT_ROWS);
+    ST7735_Scroll(StreamOffset);
+  }
+  for(i=0; i<PLOT_ROWS; i=i+1){
+    streamDraw(i);
+  }
+}
 // *************** ST7735_OutChar ********************
 // Output one character to the LCD
 // Position determined by ST7735_SetCursor command
@@ -1664,6 +4061,7 @@ void ST7735_PlotNextErase(void){
 // Inputs: 8-bit ASCII character
 // Outputs: none
 void ST7735_OutChar(char ch){
+  char str[2];
   if((ch == 10) || (ch == 13) || (ch == 27)){
     StY++; StX=0;
     if(StY>15){
@@ -1672,11 +4070,13 @@ void ST7735_OutChar(char ch){
     ST7735_DrawString(0,StY,"                     ",StTextColor);
     return;
   }
-  ST7735_DrawCharS(StX*6,StY*10,ch,ST7735_YELLOW,ST7735_BLACK, 1);
+  str[0] = ch;
+  str[1] = 0;
+  ST7735_DrawText(StX*6,StY*10,str,ST7735_YELLOW,ST7735_BLACK, 1);
   StX++;
   if(StX>20){
     StX = 20;
-    ST7735_DrawCharS(StX*6,StY*10,'*',ST7735_RED,ST7735_BLACK, 1);
+    ST7735_DrawText(StX*6,StY*10,"*",ST7735_RED,ST7735_BLACK, 1);
   }
   return;
 }
@@ -1688,9 +4088,24 @@ void ST7735_OutChar(char ch){
 // inputs: ptr  pointer to NULL-terminated ASCII string
 // outputs: none
 void ST7735_OutString(char *ptr){
+  char run[22];
+  uint32_t n;
   while(*ptr){
-    ST7735_OutChar(*ptr);
-    ptr = ptr + 1;
+    n = 0;                              // printable characters that fit on this line
+    while(ptr[n] && (ptr[n] != 10) && (ptr[n] != 13) && (ptr[n] != 27) &&
+          (StX + n < 20) && (n < 21)){
+      run[n] = ptr[n];
+      n++;
+    }
+    if(n <= 1){                         // newline, line overflow or a single character
+      ST7735_OutChar(*ptr);
+      ptr = ptr + 1;
+    } else{                             // one address window for the run
+      run[n] = 0;
+      ST7735_DrawText(StX*6,StY*10,run,ST7735_YELLOW,ST7735_BLACK, 1);
+      StX = StX + n;
+      ptr = ptr + n;
+    }
   }
 }
 // ************** ST7735_SetTextColor ************************
@@ -1702,20 +4117,25 @@ void ST7735_OutString(char *ptr){
 void ST7735_SetTextColor(uint16_t color){
   StTextColor = color;
 }
+#if !ST7735_HOST // a PC build keeps the C library's stdio
 // Print a character to ST7735 LCD.
 int fputc(int ch, FILE *f){
+  (void)f;
   ST7735_OutChar(ch);
   return 1;
 }
 // No input from Nokia, always return data.
 int fgetc (FILE *f){
+  (void)f;
   return 0;
 }
 // Function called when file error occurs.
 int ferror(FILE *f){
+  (void)f;
   /* Your implementation of ferror */
   return EOF;
 }
+#endif
 // Abstraction of general output device
 // Volume 2 section 3.4.5
 
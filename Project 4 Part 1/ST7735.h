@@ -35,18 +35,85 @@
 #define ST7735_TFTWIDTH  128
 #define ST7735_TFTHEIGHT 160
 
+// 1 to build the 8-bit palette framebuffer (20 KB of RAM), 0 to leave it out
+#ifndef ST7735_FRAMEBUFFER
+#define ST7735_FRAMEBUFFER 1
+#endif
+
+// Rows per band of ST7735_DrawList when there is no framebuffer; its two
+// band buffers take 2*ST7735_BAND_ROWS*ST7735_TFTHEIGHT*2 bytes of RAM
+#ifndef ST7735_BAND_ROWS
+#define ST7735_BAND_ROWS 16
+#endif
+
+// 1 to build the driver for a PC against the panel model in ST7735_Sim.c
+// (see ST7735_Host.h) instead of the TM4C123 registers
+#ifndef ST7735_HOST
+#define ST7735_HOST 0
+#endif
+
+// 1 to count the bytes sent to the LCD (ST7735_BytesSent) and the
+// calls, pixels and bytes of each drawing primitive (ST7735_Stats),
+// 0 to leave the counters out
+#ifndef ST7735_STATS
+#define ST7735_STATS 0
+#endif
+
+// Define ST7735_FIXED_TAB as the initRFlags value of the panel (1 for
+// INITR_REDTAB) and ST7735_FIXED_ROTATION as 0 to 3 to build the driver
+// for that one panel and orientation.  The screen size and the panel
+// offsets become constants, so the clipping and address math folds at
+// compile time.  ST7735_InitR then sets up the fixed panel whatever tab
+// it is passed and ST7735_SetRotation only resends the fixed rotation.
+#ifdef ST7735_FIXED_TAB
+#define ST7735_FIXED 1
+#ifndef ST7735_FIXED_ROTATION
+#define ST7735_FIXED_ROTATION 0
+#endif
+#if ST7735_FIXED_ROTATION & 1
+#define ST7735_WIDTH  ST7735_TFTHEIGHT  // screen size in the fixed rotation
+#define ST7735_HEIGHT ST7735_TFTWIDTH
+#else
+#define ST7735_WIDTH  ST7735_TFTWIDTH
+#define ST7735_HEIGHT ST7735_TFTHEIGHT
+#endif
+#else
+#define ST7735_FIXED 0
+#endif
+
+// Number of panels driven, 1 to 4; panel n is wired to the SSI module
+// and pins given for it at the top of ST7735.c.  Each extra panel takes
+// about 680 bytes of RAM.  Panel 2 needs R9 and R10 removed from the
+// LaunchPad (they join PD0/PD1 to PB6/PB7), panel 3 uses the RGB LED
+// pins PF1-PF3.
+#ifndef ST7735_PANELS
+#define ST7735_PANELS 1
+#endif
+
 enum initRFlags {
   INITR_GREENTAB = 0x0,
   INITR_REDTAB   = 0x1,
   INITR_BLACKTAB = 0x2
 };
 
+// Choose the panel (0 to ST7735_PANELS-1) that the other functions work on
+void ST7735_SelectPanel(uint8_t n);
+
+// Returns the panel chosen by ST7735_SelectPanel
+uint8_t ST7735_CurrentPanel(void);
+
 // Initialization for ST7735B screens
 void ST7735_InitB(void);
 
 // Initialization for ST7735R screens (green or red tabs)
 void ST7735_InitR(enum initRFlags option);
 
+// Start the ST7735R initialization in the background (Timer2A); drawing waits until it is done
+void ST7735_StartInitR(enum initRFlags option);
+
+// Returns 1 while a background initialization is in progress
+int ST7735_InitBusy(void);
+
 // Draw a pixel at the given coordinates with the given color
 void ST7735_DrawPixel(int16_t x, int16_t y, uint16_t color);
 
@@ -71,6 +138,10 @@ void ST7735_DrawCircle(uint8_t x0, uint8_t y0, uint8_t r, uint16_t color);
 // Fill a circle with the given radius and color
 void ST7735_FillCircle(uint8_t x0, uint8_t y0, uint8_t r, uint16_t color);
 
+// Fill a triangle with the given corners and color
+void ST7735_FillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                         int16_t x2, int16_t y2, uint16_t color);
+
 
 // Pass 8-bit (each) R,G,B and get back 16-bit packed color
 uint16_t ST7735_Color565(uint8_t r, uint8_t g, uint8_t b);
@@ -81,15 +152,57 @@ uint16_t ST7735_SwapColor(uint16_t x);
 // Displays a 16-bit color BMP image
 void ST7735_DrawBitmap(int16_t x, int16_t y, const uint16_t *image, int16_t w, int16_t h);
 
+// flags for ST7735_DrawBitmapScaled()
+#define ST7735_FLIP_V  0x01   // image rows are stored bottom-up (BMP order, as in bitmaps.h)
+
+// Displays a 16-bit color image enlarged by an integer scale using one address window
+void ST7735_DrawBitmapScaled(int16_t x, int16_t y, const uint16_t *image, int16_t w, int16_t h, uint8_t scale, uint8_t flags);
+
+// Run-length encoded, palette-indexed image (generated by rle_icons.py)
+// data[] is a stream of tokens covering the image top row first:
+//   0x00-0x7F literal: (token+1) palette indices follow, one per byte
+//             when bpp==8, two per byte (high nibble first) when bpp==4
+//   0x80-0xFF run: (token-0x80+1) copies of the palette index in the next byte
+typedef struct {
+  uint8_t w, h;                 // size in pixels
+  uint8_t bpp;                  // bits per palette index in literals, 4 or 8
+  uint8_t paletteSize;          // number of colors in palette[]
+  const uint16_t *palette;      // 16-bit colors
+  const uint8_t *data;          // encoded pixels
+} ST7735_RLEImage;
+
+// Displays a run-length encoded image enlarged by an integer scale using one address window
+void ST7735_DrawRLEImage(int16_t x, int16_t y, const ST7735_RLEImage *image, uint8_t scale);
+
 // Simple character draw function
 void ST7735_DrawCharS(int16_t x, int16_t y, char c, int16_t textColor, int16_t bgColor, uint8_t size);
 
 // Advanced character draw function
 void ST7735_DrawChar(int16_t x, int16_t y, char c, int16_t textColor, int16_t bgColor, uint8_t size);
 
+// String draw function using one address window per string, any size and colors
+uint32_t ST7735_DrawText(int16_t x, int16_t y, const char *pt, int16_t textColor, int16_t bgColor, uint8_t size);
+
 // String draw function
 uint32_t ST7735_DrawString(uint16_t x, uint16_t y, char *pt, int16_t textColor);
 
+// Text field: len character cells of 6*size by 8*size pixels in a row
+// that remembers the character each cell shows
+#define ST7735_FIELD_MAX 21     // cells, one row of size 1 characters
+typedef struct {
+  int16_t x, y;                 // top left corner of the first cell
+  uint8_t len;                  // number of cells, up to ST7735_FIELD_MAX
+  uint8_t size;                 // number of pixels per character pixel
+  uint16_t color, bgColor;
+  char shown[ST7735_FIELD_MAX]; // character in each cell, 0 if not known
+} ST7735_TextField;
+
+// Show text in a text field, repainting only the cells whose character changes
+uint32_t ST7735_UpdateTextField(ST7735_TextField *f, const char *text);
+
+// Tell a text field what its cells show without drawing (0 for not known)
+void ST7735_SetTextFieldShown(ST7735_TextField *f, const char *text);
+
 // Move the cursor to the desired X- and Y-position
 void ST7735_SetCursor(uint32_t newX, uint32_t newY);
 
@@ -102,6 +215,206 @@ void ST7735_SetRotation(uint8_t m);
 // Send the command to invert all of the colors
 void ST7735_InvertDisplay(int i);
 
+// Fix top and bottom rows and let the rows between scroll vertically
+void ST7735_SetScrollArea(uint16_t top, uint16_t bottom);
+
+// Move the picture in the scrolling area down by offset rows (wraps around)
+void ST7735_Scroll(uint16_t offset);
+
+// Turn the panel's 8-color, low-power idle mode on (non-zero) or off (0)
+void ST7735_SetIdleMode(int enable);
+
+// Turn the display off and put the LCD to sleep (frame memory is kept)
+void ST7735_Sleep(void);
+
+// Wake the LCD and turn the display back on (blocks about 130 ms)
+void ST7735_Wake(void);
+
+// Fill a rectangle with one color in the background using uDMA
+void ST7735_PushColorDMA(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+
+// Copy a top-down buffer of pixels to a rectangle in the background using uDMA
+void ST7735_PushPixelsDMA(int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t *pixels);
+
+// Returns 1 while a background uDMA pixel stream is in progress
+int ST7735_DMABusy(void);
+
+// Wait for the background uDMA pixel stream to finish
+void ST7735_DMAWait(void);
+
+// Register a function called (from the panel's SSI handler) when a uDMA pixel stream completes
+void ST7735_SetDMACallback(void (*task)(void));
+
+// Returns the SSI modules (bit n for SSIn) that a uDMA pixel stream of any panel is using
+uint32_t ST7735_StreamingSSI(void);
+
+// Returns the GPIO ports (bit n for port n, A = 0) of the panels that are set up
+uint32_t ST7735_PanelPorts(void);
+
+#if ST7735_FRAMEBUFFER
+// Turn the off-screen framebuffer on (non-zero) or off (0)
+void ST7735_SetFramebuffer(int enable);
+
+// Send the dirty regions of the framebuffer to the LCD
+void ST7735_Flush(void);
+
+// Encode the framebuffer as a compact screen image for ST7735_DrawScreen, returns its size or 0
+uint32_t ST7735_CaptureScreen(uint8_t *buf, uint32_t size);
+#else
+#define ST7735_SetFramebuffer(enable) ((void)0)
+#define ST7735_Flush() ((void)0)
+#define ST7735_CaptureScreen(buf, size) ((void)(buf), (void)(size), 0u)
+#endif
+
+// Moving object drawn by ST7735_UpdateSprites (needs the framebuffer)
+typedef struct {
+  int16_t x, y;                 // top left corner, may be outside the sprite area
+  uint8_t w, h;                 // size in pixels
+  const uint16_t *image;        // w*h pixels bottom row first (as in bitmaps.h), 0 for a solid block
+  uint16_t color;               // solid block: its color, image: the transparent color
+  uint8_t visible;              // 0 to hide it
+  // kept by the driver: where it is on the LCD
+  uint8_t shown;
+  uint8_t shownX0, shownY0, shownX1, shownY1;
+  const uint16_t *shownImage;
+  uint16_t shownColor;
+} ST7735_Sprite;
+
+#if ST7735_FRAMEBUFFER
+// Part of the screen the sprites move in and the background color behind them
+void ST7735_SetSpriteArea(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t bgColor);
+
+// Register a sprite, later ones are drawn on top; returns its index or -1 when full
+int ST7735_AddSprite(ST7735_Sprite *s);
+
+// Forget all sprites (before the screen under them is redrawn)
+void ST7735_ClearSprites(void);
+
+// Redraw and send only the rectangles of the sprites that moved or changed
+void ST7735_UpdateSprites(void);
+#else
+#define ST7735_SetSpriteArea(x, y, w, h, bgColor) ((void)0)
+#define ST7735_AddSprite(s) ((void)(s), -1)
+#define ST7735_ClearSprites() ((void)0)
+#define ST7735_UpdateSprites() ((void)0)
+#endif
+
+// Send a screen image made by ST7735_CaptureScreen to the whole screen in one address window
+void ST7735_DrawScreen(const uint8_t *image);
+
+// Display list operation for ST7735_DrawList
+enum ST7735_DrawOpCode {
+  ST7735_OP_FILLRECT,           // ST7735_FillRect(x, y, w, h, color)
+  ST7735_OP_TEXT,               // ST7735_DrawText(x, y, data, color, bgColor, size)
+  ST7735_OP_RLEIMAGE,           // ST7735_DrawRLEImage(x, y, data, size)
+  ST7735_OP_BITMAP,             // ST7735_DrawBitmap(x, y, data, w, h), y is the bottom row
+  ST7735_OP_PIXELS              // ST7735_PushPixelsDMA(x, y, w, h, data), rows top first
+};
+typedef struct {
+  uint8_t op;                   // enum ST7735_DrawOpCode
+  uint8_t size;                 // text size or image scale
+  int16_t x, y;
+  int16_t w, h;
+  uint16_t color, bgColor;
+  const void *data;             // string, ST7735_RLEImage or RGB565 pixels
+} ST7735_DrawOp;
+
+// Draw a display list; without the framebuffer it is rendered in bands while uDMA sends them
+void ST7735_DrawList(const ST7735_DrawOp *list, uint32_t n);
+
+// Commands in the asynchronous draw queue, must be a power of 2
+#ifndef ST7735_QUEUE_SIZE
+#define ST7735_QUEUE_SIZE 16
+#endif
+#if (ST7735_QUEUE_SIZE & (ST7735_QUEUE_SIZE-1))
+#error "ST7735_QUEUE_SIZE must be a power of 2"
+#endif
+
+// Queue a draw operation that SSI0_Handler sends in the background: 1 if queued,
+// 0 if the queue is full (try again later), -1 if the operation cannot be queued
+int ST7735_Enqueue(const ST7735_DrawOp *op);
+
+// Number of free entries in the draw queue
+uint32_t ST7735_QueueFree(void);
+
+// Wait until every queued operation has been sent
+void ST7735_QueueWait(void);
+
+// Plot of y values in rows 32-159, x goes from 0 to 127 (see the examples in ST7735.c)
+void ST7735_PlotClear(int32_t ymin, int32_t ymax);
+
+// Set the trace color and the plot background color used by ST7735_PlotClear and the plot functions
+void ST7735_PlotSetColors(uint16_t color, uint16_t bgColor);
+
+// Plot one point, a connected line segment, two points or a bar at the current x
+void ST7735_PlotPoint(int32_t y);
+void ST7735_PlotLine(int32_t y);
+void ST7735_PlotPoints(int32_t y1, int32_t y2);
+void ST7735_PlotBar(int32_t y);
+
+// Plot a bar for a dBfs value from 0 to 4095
+void ST7735_PlotdBfs(int32_t y);
+
+// Move x to the next column, wrapping to 0 (ST7735_PlotNextErase also clears the new column)
+void ST7735_PlotNext(void);
+void ST7735_PlotNextErase(void);
+
+// Streaming plot: one column per samplesPerColumn samples; scroll 1 uses hardware scrolling
+void ST7735_PlotStreamInit(int32_t ymin, int32_t ymax, uint16_t samplesPerColumn, int scroll);
+
+// Add one sample to the streaming plot
+void ST7735_PlotStream(int32_t y);
+
+// Draw the streaming plot history again
+void ST7735_PlotStreamRedraw(void);
+
+#if ST7735_STATS
+// Number of bytes sent to the LCDs (commands, data and pixels) since reset
+uint32_t ST7735_BytesSent(void);
+
+// Drawing primitives counted by ST7735_Stats.  The pixels and bytes
+// a primitive sends are charged to the one entered last, so one built
+// on others (ST7735_DrawCharS on ST7735_DrawPixel or ST7735_FillRect)
+// shows its own calls and the inner one the traffic, and commands
+// sent between primitives count for the one before.  Address windows
+// are charged to ST7735_PRIM_WINDOW whichever primitive sends them.
+enum ST7735_Prim {
+  ST7735_PRIM_WINDOW,           // address windows sent to the LCD: CASET, RASET, RAMWR
+  ST7735_PRIM_PIXEL,            // ST7735_DrawPixel
+  ST7735_PRIM_HLINE,            // ST7735_DrawFastHLine
+  ST7735_PRIM_VLINE,            // ST7735_DrawFastVLine
+  ST7735_PRIM_FILLRECT,         // ST7735_FillRect, ST7735_FillScreen, ST7735_PushColorDMA
+  ST7735_PRIM_BITMAP,           // ST7735_DrawBitmap, ST7735_PushPixelsDMA
+  ST7735_PRIM_BITMAPSCALED,     // ST7735_DrawBitmapScaled
+  ST7735_PRIM_RLEIMAGE,         // ST7735_DrawRLEImage
+  ST7735_PRIM_CHARS,            // ST7735_DrawCharS
+  ST7735_PRIM_CHAR,             // ST7735_DrawChar
+  ST7735_PRIM_TEXT,             // ST7735_DrawText
+  ST7735_PRIM_SCREEN,           // ST7735_DrawScreen
+  ST7735_PRIM_FLUSH,            // ST7735_Flush, ST7735_UpdateSprites
+  ST7735_PRIM_QUEUE,            // streams sent by the draw queue (ST7735_Enqueue)
+  ST7735_PRIM_OTHER,            // bytes sent before the first primitive (initialization)
+  ST7735_NUM_PRIMS
+};
+typedef struct {
+  uint32_t calls;
+  uint32_t pixels;              // pixels written, to the LCD or the framebuffer
+  uint32_t cmdBytes;            // command bytes sent to the LCD
+  uint32_t dataBytes;           // parameter and pixel bytes sent to the LCD
+} ST7735_PrimStats;
+
+// Counters of one primitive (enum ST7735_Prim) since reset or ST7735_ClearStats
+const ST7735_PrimStats *ST7735_Stats(uint8_t prim);
+
+// Short name of a primitive for reports, "" past ST7735_NUM_PRIMS
+const char *ST7735_PrimName(uint8_t prim);
+
+// Zero the counters of every primitive (ST7735_BytesSent keeps counting)
+void ST7735_ClearStats(void);
+#else
+#define ST7735_BytesSent() 0
+#endif
+
 // Standard device driver initialization function for printf
 void Output_Init(void);
 
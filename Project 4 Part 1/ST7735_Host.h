@@ -0,0 +1,101 @@
+/*
+		File: ST7735_Host.h
+		Group 17
+		Andrew Nguyen, Anton Tran, Tommy Troung, Abass Mir
+		Functionallity: Hardware seam of the ST7735 driver for a PC
+		build: the registers ST7735.c uses and its SSI data register
+		are backed by the panel model in ST7735_Sim.c.
+*/ 
+
+// ST7735_Host.h
+// Runs on a PC
+// Included by ST7735.c instead of tm4c123gh6pm.h when ST7735_HOST is 1.
+// ST7735.c reaches every register through REG32() (its SSI and GPIO
+// registers by base address, the rest through the names below) and
+// sends every frame through SSI_PUT(), always with the Data/Command
+// level it set for that frame.  Here REG32() is a word of the model's
+// register file, so the setup code runs unchanged, and each frame
+// goes to ST7735Host_Send().  There is no uDMA and no interrupt:
+// dmaStart() hands the model the whole stream at once.
+
+#ifndef _ST7735_HOST_H_
+#define _ST7735_HOST_H_
+#include <stdint.h>
+#include "tm4c123gh6pm.h"   // for the bit fields; the registers are redefined below
+
+//------------ST7735Host_Reg------------
+// Register of the simulated TM4C123.  A register reads 0 until it is
+// written, except that the peripheral-ready registers (SYSCTL_PRx)
+// read all ones and the SSI status registers read transmit FIFO
+// empty, so the driver never waits on the hardware.
+// Input: address  TM4C123 address of the register
+// Output: pointer to its value in the model
+volatile uint32_t *ST7735Host_Reg(uint32_t address);
+
+//------------ST7735Host_Send------------
+// One frame written to the SSI data register of a panel.
+// Input: panel  panel number, 0 to ST7735_PANELS-1
+//        data   0 for a command, 1 for parameters and pixels (the Data/Command pin)
+//        value  8-bit frame, or 16-bit frame sent most significant byte first
+//        bits16 1 for a 16-bit frame
+// Output: none
+void ST7735Host_Send(uint8_t panel, uint8_t data, uint16_t value, uint8_t bits16);
+
+#define REG32(address) (*ST7735Host_Reg(address))
+
+#undef  NVIC_EN0_R
+#define NVIC_EN0_R           REG32(0xE000E100)
+#undef  NVIC_DIS0_R
+#define NVIC_DIS0_R          REG32(0xE000E180)
+#undef  NVIC_PRI0_R
+#define NVIC_PRI0_R          REG32(0xE000E400)
+#undef  NVIC_PRI5_R
+#define NVIC_PRI5_R          REG32(0xE000E414)
+#undef  SYSCTL_RCGCTIMER_R
+#define SYSCTL_RCGCTIMER_R   REG32(0x400FE604)
+#undef  SYSCTL_RCGCGPIO_R
+#define SYSCTL_RCGCGPIO_R    REG32(0x400FE608)
+#undef  SYSCTL_RCGCDMA_R
+#define SYSCTL_RCGCDMA_R     REG32(0x400FE60C)
+#undef  SYSCTL_RCGCSSI_R
+#define SYSCTL_RCGCSSI_R     REG32(0x400FE61C)
+#undef  SYSCTL_PRTIMER_R
+#define SYSCTL_PRTIMER_R     REG32(0x400FEA04)
+#undef  SYSCTL_PRGPIO_R
+#define SYSCTL_PRGPIO_R      REG32(0x400FEA08)
+#undef  SYSCTL_PRDMA_R
+#define SYSCTL_PRDMA_R       REG32(0x400FEA0C)
+#undef  TIMER2_CFG_R
+#define TIMER2_CFG_R         REG32(0x40032000)
+#undef  TIMER2_TAMR_R
+#define TIMER2_TAMR_R        REG32(0x40032004)
+#undef  TIMER2_CTL_R
+#define TIMER2_CTL_R         REG32(0x4003200C)
+#undef  TIMER2_IMR_R
+#define TIMER2_IMR_R         REG32(0x40032018)
+#undef  TIMER2_ICR_R
+#define TIMER2_ICR_R         REG32(0x40032024)
+#undef  TIMER2_TAILR_R
+#define TIMER2_TAILR_R       REG32(0x40032028)
+#undef  TIMER2_TAPR_R
+#define TIMER2_TAPR_R        REG32(0x40032038)
+#undef  UDMA_CFG_R
+#define UDMA_CFG_R           REG32(0x400FF004)
+#undef  UDMA_CTLBASE_R
+#define UDMA_CTLBASE_R       REG32(0x400FF008)
+#undef  UDMA_USEBURSTCLR_R
+#define UDMA_USEBURSTCLR_R   REG32(0x400FF01C)
+#undef  UDMA_REQMASKCLR_R
+#define UDMA_REQMASKCLR_R    REG32(0x400FF024)
+#undef  UDMA_ENASET_R
+#define UDMA_ENASET_R        REG32(0x400FF028)
+#undef  UDMA_ALTCLR_R
+#define UDMA_ALTCLR_R        REG32(0x400FF034)
+#undef  UDMA_PRIOCLR_R
+#define UDMA_PRIOCLR_R       REG32(0x400FF03C)
+#undef  UDMA_CHIS_R
+#define UDMA_CHIS_R          REG32(0x400FF504)
+#undef  UDMA_CHMAP0_R
+#define UDMA_CHMAP0_R        REG32(0x400FF510)
+
+#endif
@@ -0,0 +1,456 @@
+/*
+		File: ST7735_Sim.c
+		Group 17
+		Andrew Nguyen, Anton Tran, Tommy Troung, Abass Mir
+		Functionallity: PC simulator of the ST7735 LCD. Runs the
+		unchanged driver and the weather screens against a model of
+		the panel, reports the bytes each operation sends and saves
+		what the panel shows as PNG images.
+*/ 
+
+// ST7735_Sim.c
+// Runs on a PC
+// Build and run from this folder with
+//   make -f Makefile.sim
+// which compiles the driver with the defines of the ST7735_Benchmark
+// target (BENCHMARK leaves main() out of WeatherDisplay.c; the fixed
+// red tab panel in rotation 0) and runs the simulation, writing the
+// images to sim/.  The panel is brought up with ST7735_StartInitR,
+// its Timer2A ticks called here until it is ready.  Each operation
+// below starts from a black screen and prints one line:
+//   name  bytes  commands  data  windows  budget
+// bytes is everything the driver sent to the panel (commands,
+// parameters and pixels), windows the RAMWR commands.  An operation
+// that sends more than its budget is marked OVER and the program
+// exits with 1, so it can guard the drawing code against
+// regressions.  After each operation the panel's frame memory is
+// written to <name>.png.  Then the line and circle functions are
+// checked against pixel-at-a-time references (Shape check below);
+// any case that differs also makes the program exit with 1.
+//
+// Panel model: the command and data stream of each panel is decoded
+// as the ST7735R controller does for the commands the driver uses
+// for drawing (SWRESET, CASET, RASET, RAMWR, MADCTL); the others are
+// only counted.  Frame memory is kept in the address space of CASET
+// and RASET, so the image is the screen as the driver draws it in
+// any rotation (MADCTL MV swaps width and height), before hardware
+// scrolling.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ST7735.h"
+#include "ST7735_Host.h"
+
+void drawScreen(int state);             // WeatherDisplay.c
+void animateScreen(int state);
+void Timer2A_Handler(void);             // ST7735.c, the 1 ms background init tick
+
+// --- Register file ---
+#define NUM_REGS 128
+static uint32_t RegAddress[NUM_REGS];
+static volatile uint32_t RegValue[NUM_REGS];
+static uint32_t NumRegs;
+
+// Value of a register the driver has not written yet
+static uint32_t regReset(uint32_t address){
+  if((address >= 0x400FEA00) && (address < 0x400FEB00)) return 0xFFFFFFFF; // SYSCTL_PRx: ready
+  if((address >= 0x40008000) && (address < 0x4000C000) && ((address&0xFFF) == 0x00C)){
+    return SSI_SR_TNF|SSI_SR_TFE;       // transmit FIFO empty, not busy
+  }
+  return 0;
+}
+
+volatile uint32_t *ST7735Host_Reg(uint32_t address){
+  for(uint32_t i = 0; i < NumRegs; i++){
+    if(RegAddress[i] == address) return &RegValue[i];
+  }
+  if(NumRegs == NUM_REGS){
+    fprintf(stderr, "register file full at 0x%08X\n", (unsigned)address);
+    return &RegValue[NUM_REGS-1];
+  }
+  RegAddress[NumRegs] = address;
+  RegValue[NumRegs] = regReset(address);
+  return &RegValue[NumRegs++];
+}
+
+// --- Panel model ---
+#define SIM_COLS 132                    // frame memory of the ST7735R (GM = 11)
+#define SIM_ROWS 162
+#define CMD_SWRESET 0x01
+#define CMD_CASET   0x2A
+#define CMD_RASET   0x2B
+#define CMD_RAMWR   0x2C
+#define CMD_MADCTL  0x36
+#define MADCTL_MV   0x20
+typedef struct {
+  uint16_t ram[SIM_ROWS][SIM_COLS];     // by RASET row and CASET column
+  uint8_t cmd;                          // last command
+  uint8_t args[4], numArgs;             // parameters received so far
+  uint8_t xs, xe, ys, ye, x, y;         // window and write pointer
+  uint8_t madctl;
+  uint8_t high, haveHigh;               // first byte of a pixel
+  uint32_t cmdBytes, dataBytes, windows;
+} SimPanel;
+static SimPanel Sim[ST7735_PANELS];
+
+static void simByte(SimPanel *s, uint8_t data, uint8_t b){
+  if(!data){
+    s->cmdBytes++;
+    s->cmd = b;
+    s->numArgs = 0;
+    s->haveHigh = 0;
+    if(b == CMD_SWRESET){
+      s->xs = s->ys = 0;
+      s->xe = SIM_COLS - 1;
+      s->ye = SIM_ROWS - 1;
+      s->madctl = 0;
+    } else if(b == CMD_RAMWR){
+      s->x = s->xs;
+      s->y = s->ys;
+      s->windows++;
+    }
+    return;
+  }
+  s->dataBytes++;
+  switch(s->cmd){
+    case CMD_CASET:
+    case CMD_RASET:
+      if(s->numArgs < 4) s->args[s->numArgs++] = b;
+      if(s->numArgs == 4){              // the high bytes are 0 on this panel
+        if(s->cmd == CMD_CASET){
+          s->xs = s->args[1];
+          s->xe = s->args[3];
+        } else{
+          s->ys = s->args[1];
+          s->ye = s->args[3];
+        }
+      }
+      break;
+    case CMD_MADCTL:
+      s->madctl = b;
+      break;
+    case CMD_RAMWR:
+      if(!s->haveHigh){
+        s->high = b;
+        s->haveHigh = 1;
+        break;
+      }
+      s->haveHigh = 0;
+      if((s->x < SIM_COLS) && (s->y < SIM_ROWS)) s->ram[s->y][s->x] = (s->high<<8)|b;
+      if(s->x < s->xe){                 // left to right, then top to bottom, wrapping
+        s->x++;
+      } else{
+        s->x = s->xs;
+        s->y = (s->y < s->ye) ? (s->y + 1) : s->ys;
+      }
+      break;
+  }
+}
+
+void ST7735Host_Send(uint8_t panel, uint8_t data, uint16_t value, uint8_t bits16){
+  SimPanel *s = &Sim[panel];
+  if(bits16) simByte(s, data, value>>8);
+  simByte(s, data, value&0xFF);
+}
+
+// --- PNG output ---
+// 8-bit RGB with uncompressed (stored) deflate blocks, one per row
+static uint32_t CrcTable[256];
+
+static uint32_t crc32(uint32_t crc, const uint8_t *p, uint32_t n){
+  if(CrcTable[1] == 0){
+    for(uint32_t i = 0; i < 256; i++){
+      uint32_t c = i;
+      for(int k = 0; k < 8; k++) c = (c & 1) ? (0xEDB88320 ^ (c>>1)) : (c>>1);
+      CrcTable[i] = c;
+    }
+  }
+  crc = ~crc;
+  while(n--) crc = CrcTable[(crc ^ *p++)&0xFF] ^ (crc>>8);
+  return ~crc;
+}
+
+static void put32(uint8_t *p, uint32_t v){
+  p[0] = v>>24; p[1] = v>>16; p[2] = v>>8; p[3] = v;
+}
+
+static void pngChunk(FILE *f, const char *type, const uint8_t *data, uint32_t n){
+  uint8_t head[8];
+  uint8_t tail[4];
+  put32(head, n);
+  memcpy(&head[4], type, 4);
+  put32(tail, crc32(crc32(0, &head[4], 4), data, n));
+  fwrite(head, 1, 8, f);
+  fwrite(data, 1, n, f);
+  fwrite(tail, 1, 4, f);
+}
+
+static int writePNG(const char *path, const SimPanel *s){
+  static uint8_t idat[2 + SIM_ROWS*(5 + 1 + 3*SIM_ROWS) + 4];
+  uint8_t ihdr[13] = {0};
+  uint32_t w = (s->madctl & MADCTL_MV) ? ST7735_TFTHEIGHT : ST7735_TFTWIDTH;
+  uint32_t h = (s->madctl & MADCTL_MV) ? ST7735_TFTWIDTH : ST7735_TFTHEIGHT;
+  uint32_t n = 0, a = 1, b = 0;         // idat length, Adler-32 sums
+  FILE *f = fopen(path, "wb");
+  if(!f) return 0;
+  put32(ihdr, w);
+  put32(&ihdr[4], h);
+  ihdr[8] = 8;                          // bits per channel
+  ihdr[9] = 2;                          // RGB
+  idat[n++] = 0x78;                     // zlib header, no compression
+  idat[n++] = 0x01;
+  for(uint32_t y = 0; y < h; y++){
+    uint32_t len = 1 + 3*w;             // filter byte, then the row
+    uint8_t *row = &idat[n + 5];
+    idat[n] = (y == h - 1);             // stored block, the last one is final
+    idat[n+1] = len; idat[n+2] = len>>8;
+    idat[n+3] = ~len; idat[n+4] = (~len)>>8;
+    row[0] = 0;
+    for(uint32_t x = 0; x < w; x++){
+      uint16_t c = s->ram[y][x];        // RGB565 as in the ST7735_ color constants
+      row[1 + 3*x] = ((c>>11)&0x1F)*255/31;
+      row[2 + 3*x] = ((c>>5)&0x3F)*255/63;
+      row[3 + 3*x] = (c&0x1F)*255/31;
+    }
+    for(uint32_t i = 0; i < len; i++){
+      a = (a + row[i])%65521;
+      b = (b + a)%65521;
+    }
+    n = n + 5 + len;
+  }
+  put32(&idat[n], (b<<16)|a);
+  n = n + 4;
+  fwrite("\x89PNG\r\n\x1a\n", 1, 8, f);
+  pngChunk(f, "IHDR", ihdr, 13);
+  pngChunk(f, "IDAT", idat, n);
+  pngChunk(f, "IEND", 0, 0);
+  fclose(f);
+  return 1;
+}
+
+// --- Operations ---
+// The weather screens as WeatherDisplay shows them: the static layer
+// and the first animation frame composed in the framebuffer, then sent
+static void showScreen(int state){
+  ST7735_SetFramebuffer(1);
+  drawScreen(state);
+  animateScreen(state);
+  ST7735_Flush();
+  ST7735_SetFramebuffer(0);
+}
+static void sunnyScreen(void){ showScreen(0); }
+static void cloudyScreen(void){ showScreen(1); }
+static void rainyScreen(void){ showScreen(2); }
+static void rainyDirect(void){         // framebuffer off: the fill, then the text over it
+  drawScreen(2);                        // (in bands in a build without the framebuffer)
+}
+
+static void fillScreen(void){
+  ST7735_FillScreen(ST7735_BLUE);
+}
+
+static void drawText(void){
+  ST7735_DrawText(4, 10, "Carson, CA", ST7735_YELLOW, ST7735_BLACK, 2);
+}
+
+// --- Shape check ---
+// ST7735_DrawLine, ST7735_DrawCircle and ST7735_FillCircle send runs
+// of pixels as lines and rectangles.  The reference functions below
+// are the original pixel-at-a-time versions (Bresenham line, midpoint
+// circle, columns of the filled circle), plotting into a mask with
+// every pixel clipped to the screen.  Each random case is drawn by the
+// driver on a black screen and must light exactly the mask's pixels.
+#define CHECK_CASES  3000               // a third each of lines, circles and filled circles
+#define CHECK_COLOR  ST7735_WHITE
+static uint8_t RefMask[ST7735_TFTHEIGHT][ST7735_TFTWIDTH];
+static uint32_t Seed = 1;
+
+static int32_t randRange(int32_t lo, int32_t hi){ // lo to hi inclusive
+  Seed = Seed*1103515245 + 12345;
+  return lo + (int32_t)((Seed>>16)%(uint32_t)(hi - lo + 1));
+}
+
+static void refPixel(int32_t x, int32_t y){
+  if((x < 0) || (x >= ST7735_TFTWIDTH) || (y < 0) || (y >= ST7735_TFTHEIGHT)) return;
+  RefMask[y][x] = 1;
+}
+
+static void refVLine(int32_t x, int32_t y, int32_t h){
+  while(h-- > 0) refPixel(x, y++);
+}
+
+static void refLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1){
+  int32_t steep = abs(y1 - y0) > abs(x1 - x0);
+  int32_t dx, dy, err, ystep, t;
+  if(steep){
+    t = x0; x0 = y0; y0 = t;
+    t = x1; x1 = y1; y1 = t;
+  }
+  if(x0 > x1){
+    t = x0; x0 = x1; x1 = t;
+    t = y0; y0 = y1; y1 = t;
+  }
+  dx = x1 - x0;
+  dy = abs(y1 - y0);
+  err = dx/2;
+  ystep = (y0 < y1) ? 1 : -1;
+  for(; x0<=x1; x0++){
+    if(steep){
+      refPixel(y0, x0);
+    } else{
+      refPixel(x0, y0);
+    }
+    err -= dy;
+    if(err < 0){
+      y0 += ystep;
+      err += dx;
+    }
+  }
+}
+
+static void refCircle(int32_t x0, int32_t y0, int32_t r, int fill){
+  int32_t f = 1 - r, ddF_x = 1, ddF_y = -2*r, x = 0, y = r;
+  if(fill){
+    refVLine(x0, y0-r, 2*r+1);
+  } else{
+    refPixel(x0, y0+r);
+    refPixel(x0, y0-r);
+    refPixel(x0+r, y0);
+    refPixel(x0-r, y0);
+  }
+  while(x < y){
+    if(f >= 0){
+      y--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    x++;
+    ddF_x += 2;
+    f += ddF_x;
+    if(fill){
+      refVLine(x0+x, y0-y, 2*y+1);
+      refVLine(x0-x, y0-y, 2*y+1);
+      refVLine(x0+y, y0-x, 2*x+1);
+      refVLine(x0-y, y0-x, 2*x+1);
+    } else{
+      refPixel(x0+x, y0+y); refPixel(x0-x, y0+y);
+      refPixel(x0+x, y0-y); refPixel(x0-x, y0-y);
+      refPixel(x0+y, y0+x); refPixel(x0-y, y0+x);
+      refPixel(x0+y, y0-x); refPixel(x0-y, y0-x);
+    }
+  }
+}
+
+// Runs the random cases, returns how many differ from the reference
+static uint32_t checkShapes(void){
+  uint32_t bad = 0;
+  for(uint32_t i = 0; i < CHECK_CASES; i++){
+    int32_t a = randRange(-20, ST7735_TFTWIDTH + 19); // lines may run off every edge
+    int32_t b = randRange(-20, ST7735_TFTHEIGHT + 19);
+    int32_t c = randRange(-20, ST7735_TFTWIDTH + 19);
+    int32_t d = randRange(-20, ST7735_TFTHEIGHT + 19);
+    int32_t r = randRange(0, 50);
+    uint32_t wrong = 0;
+    memset(RefMask, 0, sizeof(RefMask));
+    ST7735_FillScreen(ST7735_BLACK);
+    if(i%3 == 0){
+      refLine(a, b, c, d);
+      ST7735_DrawLine(a, b, c, d, CHECK_COLOR);
+    } else{                            // the center is a uint8_t, on the screen
+      a = randRange(0, ST7735_TFTWIDTH - 1);
+      b = randRange(0, ST7735_TFTHEIGHT - 1);
+      refCircle(a, b, r, i%3 == 2);
+      if(i%3 == 1){
+        ST7735_DrawCircle(a, b, r, CHECK_COLOR);
+      } else{
+        ST7735_FillCircle(a, b, r, CHECK_COLOR);
+      }
+    }
+    ST7735_DMAWait();
+    for(int32_t y = 0; y < ST7735_TFTHEIGHT; y++){
+      for(int32_t x = 0; x < ST7735_TFTWIDTH; x++){
+        if((Sim[0].ram[y][x] == CHECK_COLOR) != RefMask[y][x]) wrong++;
+      }
+    }
+    if(wrong){
+      if(bad < 10){
+        printf("  case %u: %s %d,%d %d,%d r %d: %u pixels differ\n", (unsigned)i,
+               (i%3 == 0) ? "line" : (i%3 == 1) ? "circle" : "fill", (int)a, (int)b,
+               (int)c, (int)d, (int)r, (unsigned)wrong);
+      }
+      bad++;
+    }
+  }
+  return bad;
+}
+
+typedef struct {
+  char *name;
+  void (*run)(void);
+  uint32_t budget;                      // bytes, 0 for none
+} SimOp;
+
+// The budgets are the bytes measured for this build plus up to 2%, so
+// a change that sends more has to raise them on purpose
+static const SimOp Ops[] = {
+  {"FillScreen",    fillScreen,   41000}, // one window: 40960 pixel bytes
+  {"DrawText",      drawText,     3950},
+  {"SunnyScreen",   sunnyScreen,  41000},
+  {"CloudyScreen",  cloudyScreen, 41000},
+  {"RainyScreen",   rainyScreen,  41000},
+  {"RainyDirect",   rainyDirect,  53400},
+};
+#define NUM_OPS (sizeof(Ops)/sizeof(Ops[0]))
+
+int main(int argc, char **argv){
+  const char *folder = (argc > 1) ? argv[1] : ".";
+  int over = 0;
+  uint32_t bad;
+  uint32_t ms = 0;
+  static const ST7735_DrawOp early = {.op = ST7735_OP_FILLRECT, .x = 10, .y = 20,
+                                      .w = 8, .h = 8, .color = ST7735_RED};
+  ST7735_StartInitR(INITR_REDTAB);
+  ST7735_Enqueue(&early);               // queued while the init holds the panel
+  while(ST7735_InitBusy()){             // one Timer2A interrupt per millisecond
+    if(ms == 1000){
+      fprintf(stderr, "the panel init did not finish\n");
+      return 1;
+    }
+    Timer2A_Handler();
+    ms++;
+  }
+  printf("init %u ms\n", (unsigned)ms);
+  if(ST7735_DMABusy() || (Sim[0].ram[27][17] != ST7735_RED)){
+    fprintf(stderr, "the operation queued during the init was not sent\n");
+    return 1;
+  }
+  ST7735_SetFramebuffer(0);
+  printf("name               bytes  commands      data   windows    budget\n");
+  for(uint32_t i = 0; i < NUM_OPS; i++){
+    SimPanel *s = &Sim[0];
+    uint32_t cmd, data, windows;
+    char path[256];
+    ST7735_FillScreen(ST7735_BLACK);    // same starting screen for every run
+    ST7735_DMAWait();
+    cmd = s->cmdBytes;
+    data = s->dataBytes;
+    windows = s->windows;
+    Ops[i].run();
+    ST7735_DMAWait();
+    cmd = s->cmdBytes - cmd;
+    data = s->dataBytes - data;
+    windows = s->windows - windows;
+    printf("%-14s %9u %9u %9u %9u %9u%s\n", Ops[i].name, (unsigned)(cmd + data),
+           (unsigned)cmd, (unsigned)data, (unsigned)windows, (unsigned)Ops[i].budget,
+           (Ops[i].budget && (cmd + data > Ops[i].budget)) ? "  OVER" : "");
+    if(Ops[i].budget && (cmd + data > Ops[i].budget)) over = 1;
+    snprintf(path, sizeof(path), "%s/%s.png", folder, Ops[i].name);
+    if(!writePNG(path, s)) fprintf(stderr, "cannot write %s\n", path);
+  }
+  bad = checkShapes();
+  printf("shapes: %u of %u random cases differ from the reference\n",
+         (unsigned)bad, (unsigned)CHECK_CASES);
+  return over || bad;
+}
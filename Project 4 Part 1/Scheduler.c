@@ -0,0 +1,122 @@
+/*
+		File: Scheduler.c
+		Group 17
+		Andrew Nguyen, Anton Tran, Tommy Troung, Abass Mir
+		Functionallity: Implements the SysTick tick counter and the
+		cooperative periodic task loop declared in Scheduler.h.
+*/ 
+
+// Scheduler.c
+// Runs on TM4C123
+// SysTick_Handler only counts ticks; all tasks run from
+// Scheduler_Run() in the main thread, so there is nothing to share
+// between the ISR and the tasks except Ticks.
+
+#include <stdint.h>
+#include "Scheduler.h"
+#include "tm4c123gh6pm.h"
+
+void WaitForInterrupt(void);  // low power mode, in startup.s
+
+typedef struct {
+  void (*task)(void);
+  uint32_t period;        // ticks between calls
+  uint32_t countdown;     // ticks until the next call
+} SchedTask;
+
+static SchedTask Tasks[SCHED_MAXTASKS];
+static uint32_t NumTasks;
+static volatile uint32_t Ticks;
+static uint32_t Overruns;
+static void (*Idle)(void);            // 0: plain WFI
+
+//------------Scheduler_Init------------
+// Set up SysTick to interrupt tickHz times a second and clear the
+// task list. SysTick runs from the core clock.
+// Input: busClockHz  core clock in Hz, Clock_BusHz()
+//        tickHz      tick rate in Hz, busClockHz/tickHz must fit in 24 bits
+// Output: none
+void Scheduler_Init(uint32_t busClockHz, uint32_t tickHz){
+  NumTasks = 0;
+  Ticks = 0;
+  Overruns = 0;
+  NVIC_ST_CTRL_R = 0;                         // disable SysTick during setup
+  NVIC_ST_RELOAD_R = (busClockHz/tickHz - 1)&NVIC_ST_RELOAD_M;
+  NVIC_ST_CURRENT_R = 0;                      // any write clears it
+  NVIC_SYS_PRI3_R = (NVIC_SYS_PRI3_R&0x00FFFFFF)|0x60000000; // priority 3, below SSI0
+  NVIC_ST_CTRL_R = NVIC_ST_CTRL_ENABLE|NVIC_ST_CTRL_INTEN|NVIC_ST_CTRL_CLK_SRC;
+}
+
+//------------Scheduler_AddTask------------
+// Add a periodic task. It first runs on the next tick.
+// Input: task        function to call
+//        periodTicks call it every periodTicks ticks (0 is treated as 1)
+// Output: task number, or -1 if the table is full
+int Scheduler_AddTask(void (*task)(void), uint32_t periodTicks){
+  if(NumTasks >= SCHED_MAXTASKS) return -1;
+  if(periodTicks == 0) periodTicks = 1;
+  Tasks[NumTasks].task = task;
+  Tasks[NumTasks].period = periodTicks;
+  Tasks[NumTasks].countdown = 1;
+  NumTasks++;
+  return NumTasks - 1;
+}
+
+// Executed every SysTick period
+void SysTick_Handler(void){
+  Ticks++;
+}
+
+//------------Scheduler_SetIdle------------
+// Replace the WFI between ticks, e.g. with Power_Sleep. The function
+// is called again after every interrupt until the next tick, and must
+// return once it has been woken.
+// Input: idle  function that sleeps until an interrupt, 0 for WFI
+// Output: none
+void Scheduler_SetIdle(void (*idle)(void)){
+  Idle = idle;
+}
+
+//------------Scheduler_Run------------
+// Run the tasks forever. If the tasks of one tick take longer than a
+// tick, the missed ticks are dropped (counted by Scheduler_Overruns)
+// instead of being run back to back.
+// Input: none
+// Output: none, never returns
+void Scheduler_Run(void){
+  uint32_t last = Ticks;
+  while(1){
+    while(Ticks == last){
+      if(Idle){
+        Idle();
+      } else{
+        WaitForInterrupt();                   // sleep until SysTick (or another interrupt)
+      }
+    }
+    uint32_t now = Ticks;
+    Overruns += now - last - 1;
+    last = now;
+    for(uint32_t i = 0; i < NumTasks; i++){
+      if(--Tasks[i].countdown == 0){
+        Tasks[i].countdown = Tasks[i].period;
+        Tasks[i].task();
+      }
+    }
+  }
+}
+
+//------------Scheduler_Ticks------------
+// Number of ticks since Scheduler_Init.
+// Input: none
+// Output: tick count
+uint32_t Scheduler_Ticks(void){
+  return Ticks;
+}
+
+//------------Scheduler_Overruns------------
+// Number of ticks dropped because the tasks ran late.
+// Input: none
+// Output: dropped tick count
+uint32_t Scheduler_Overruns(void){
+  return Overruns;
+}
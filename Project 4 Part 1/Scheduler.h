@@ -0,0 +1,66 @@
+/*
+		File: Scheduler.h
+		Group 17
+		Andrew Nguyen, Anton Tran, Tommy Troung, Abass Mir
+		Functionallity: Declares a small SysTick-driven cooperative
+		scheduler that runs periodic tasks at fixed tick rates and
+		sleeps (WFI) between ticks.
+*/ 
+
+// Scheduler.h
+// Runs on TM4C123
+// SysTick interrupts at a fixed tick rate. Each task has a period in
+// ticks; Scheduler_Run() calls every task that is due, in the order the
+// tasks were added, then sleeps until the next tick. Tasks run in the
+// foreground (not in the ISR), so they may call the ST7735 driver.
+
+#ifndef _SCHEDULER_H_
+#define _SCHEDULER_H_
+#include <stdint.h>
+
+#define SCHED_MAXTASKS 8
+
+//------------Scheduler_Init------------
+// Set up SysTick to interrupt tickHz times a second and clear the
+// task list. SysTick runs from the core clock.
+// Input: busClockHz  core clock in Hz, Clock_BusHz()
+//        tickHz      tick rate in Hz, busClockHz/tickHz must fit in 24 bits
+// Output: none
+void Scheduler_Init(uint32_t busClockHz, uint32_t tickHz);
+
+//------------Scheduler_AddTask------------
+// Add a periodic task. It first runs on the next tick.
+// Input: task        function to call
+//        periodTicks call it every periodTicks ticks (0 is treated as 1)
+// Output: task number, or -1 if the table is full
+int Scheduler_AddTask(void (*task)(void), uint32_t periodTicks);
+
+//------------Scheduler_SetIdle------------
+// Replace the WFI between ticks, e.g. with Power_Sleep. The function
+// is called again after every interrupt until the next tick, and must
+// return once it has been woken.
+// Input: idle  function that sleeps until an interrupt, 0 for WFI
+// Output: none
+void Scheduler_SetIdle(void (*idle)(void));
+
+//------------Scheduler_Run------------
+// Run the tasks forever. If the tasks of one tick take longer than a
+// tick, the missed ticks are dropped (counted by Scheduler_Overruns)
+// instead of being run back to back.
+// Input: none
+// Output: none, never returns
+void Scheduler_Run(void);
+
+//------------Scheduler_Ticks------------
+// Number of ticks since Scheduler_Init.
+// Input: none
+// Output: tick count
+uint32_t Scheduler_Ticks(void);
+
+//------------Scheduler_Overruns------------
+// Number of ticks dropped because the tasks ran late.
+// Input: none
+// Output: dropped tick count
+uint32_t Scheduler_Overruns(void);
+
+#endif
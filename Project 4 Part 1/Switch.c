@@ -0,0 +1,118 @@
+/*
+		File: Switch.c
+		Group 17
+		Andrew Nguyen, Anton Tran, Tommy Troung, Abass Mir
+		Functionallity: Implements the PF4 edge interrupt, Timer1A
+		debounce and the single-producer/single-consumer event queue
+		declared in Switch.h.
+*/ 
+
+// Switch.c
+// Runs on TM4C123
+// GPIOPortF_Handler disarms PF4 and starts Timer1A, so the bounces
+// after an edge cause no further interrupts. Timer1A_Handler reads the
+// settled level, queues a press or release if it differs from the last
+// one reported, then re-arms PF4.
+
+#include <stdint.h>
+#include "Switch.h"
+#include "tm4c123gh6pm.h"
+
+#define PF4 0x10
+
+static volatile SwitchEvent Queue[SWITCH_QUEUE_SIZE];
+static volatile uint32_t PutI;    // written only by Timer1A_Handler
+static volatile uint32_t GetI;    // written only by Switch_GetEvent
+static uint32_t Dropped;
+static uint8_t Pressed;           // last level reported
+
+//------------Switch_Init------------
+// Make PF4 an input with pull-up that interrupts on both edges, and
+// set up Timer1A for debouncing. Only touches the PF4 bits, so it can
+// be called after a Port F init that sets up the LEDs.
+// Input: busClockHz  bus clock in Hz, sets the debounce timer count
+// Output: none
+void Switch_Init(uint32_t busClockHz){
+  PutI = GetI = 0;
+  Dropped = 0;
+  SYSCTL_RCGCGPIO_R |= 0x20;            // activate clock for Port F
+  SYSCTL_RCGCTIMER_R |= 0x02;           // activate clock for Timer1
+  while((SYSCTL_PRGPIO_R&0x20) == 0){};
+  while((SYSCTL_PRTIMER_R&0x02) == 0){};
+  GPIO_PORTF_DIR_R &= ~PF4;             // PF4 in
+  GPIO_PORTF_AFSEL_R &= ~PF4;
+  GPIO_PORTF_AMSEL_R &= ~PF4;
+  GPIO_PORTF_PCTL_R &= ~0x000F0000;
+  GPIO_PORTF_PUR_R |= PF4;              // SW1 pulls PF4 low
+  GPIO_PORTF_DEN_R |= PF4;
+  GPIO_PORTF_IS_R &= ~PF4;              // edge sensitive
+  GPIO_PORTF_IBE_R |= PF4;              // on both edges
+  GPIO_PORTF_ICR_R = PF4;               // clear flag4
+  GPIO_PORTF_IM_R |= PF4;               // arm interrupt on PF4
+  Pressed = (GPIO_PORTF_DATA_R&PF4) == 0;
+
+  TIMER1_CTL_R = 0;                     // disable Timer1A during setup
+  TIMER1_CFG_R = 0;                     // 32-bit mode
+  TIMER1_TAMR_R = 0x01;                 // one-shot, down-count
+  TIMER1_TAILR_R = (busClockHz/1000)*SWITCH_DEBOUNCE_MS - 1;
+  TIMER1_TAPR_R = 0;
+  TIMER1_ICR_R = 0x01;                  // clear timeout flag
+  TIMER1_IMR_R = 0x01;                  // arm timeout interrupt
+
+  NVIC_PRI5_R = (NVIC_PRI5_R&0xFFFF00FF)|0x00006000; // Timer1A is IRQ 21, priority 3
+  NVIC_PRI7_R = (NVIC_PRI7_R&0xFF00FFFF)|0x00600000; // Port F is IRQ 30, priority 3
+  NVIC_EN0_R = (1<<21)|(1<<30);
+}
+
+// First edge of a press or release: wait for the bounces to stop
+void GPIOPortF_Handler(void){
+  GPIO_PORTF_IM_R &= ~PF4;              // disarm until the level is read
+  GPIO_PORTF_ICR_R = PF4;
+  TIMER1_CTL_R = 0x01;                  // start the one-shot
+}
+
+// Switch has been quiet for SWITCH_DEBOUNCE_MS
+void Timer1A_Handler(void){
+  TIMER1_ICR_R = 0x01;                  // acknowledge timeout
+  GPIO_PORTF_ICR_R = PF4;               // forget the bounces; edges after the read below count
+  uint8_t pressed = (GPIO_PORTF_DATA_R&PF4) == 0;
+  if(pressed != Pressed){               // ignore glitches that end where they began
+    Pressed = pressed;
+    if(PutI - GetI < SWITCH_QUEUE_SIZE){
+      Queue[PutI&(SWITCH_QUEUE_SIZE-1)] = pressed ? SW1_PRESS : SW1_RELEASE;
+      PutI = PutI + 1;                  // publish after the entry is written
+    } else{
+      Dropped++;
+    }
+  }
+  GPIO_PORTF_IM_R |= PF4;               // re-arm
+}
+
+//------------Switch_GetEvent------------
+// Take the oldest switch event off the queue, if there is one.
+// Input: event  where to store it
+// Output: 1 if an event was returned, 0 if the queue was empty
+int Switch_GetEvent(SwitchEvent *event){
+  if(GetI == PutI) return 0;
+  *event = Queue[GetI&(SWITCH_QUEUE_SIZE-1)];
+  GetI = GetI + 1;                      // free the entry after it is read
+  return 1;
+}
+
+//------------Switch_Busy------------
+// Whether the switch still needs Timer1A: an edge is being debounced
+// (the PF4 interrupt is disarmed until Timer1A_Handler) or events are
+// waiting. Deep sleep stops Timer1, so only sleep deeply when idle.
+// Input: none
+// Output: non-zero while busy, 0 when idle
+int Switch_Busy(void){
+  return ((GPIO_PORTF_IM_R&PF4) == 0) || (GetI != PutI);
+}
+
+//------------Switch_Dropped------------
+// Number of events lost because the queue was full.
+// Input: none
+// Output: dropped event count
+uint32_t Switch_Dropped(void){
+  return Dropped;
+}
@@ -0,0 +1,57 @@
+/*
+		File: Switch.h
+		Group 17
+		Andrew Nguyen, Anton Tran, Tommy Troung, Abass Mir
+		Functionallity: Declares the interrupt-driven, debounced SW1
+		(PF4) driver and its event queue.
+*/ 
+
+// Switch.h
+// Runs on TM4C123
+// A PF4 edge interrupt starts a one-shot Timer1A; when the timer
+// expires the switch has settled and its new level is queued as an
+// event. The queue has one producer (Timer1A_Handler) and one consumer
+// (the main thread), so it needs no locking.
+// Onboard Switch SW1: Connected to PF4 (negative logic, internal pull-up).
+
+#ifndef _SWITCH_H_
+#define _SWITCH_H_
+#include <stdint.h>
+
+#define SWITCH_DEBOUNCE_MS 10   // quiet time after an edge before PF4 is read
+#define SWITCH_QUEUE_SIZE  8    // events, must be a power of 2
+
+typedef enum {
+  SW1_PRESS,
+  SW1_RELEASE
+} SwitchEvent;
+
+//------------Switch_Init------------
+// Make PF4 an input with pull-up that interrupts on both edges, and
+// set up Timer1A for debouncing. Only touches the PF4 bits, so it can
+// be called after a Port F init that sets up the LEDs.
+// Input: busClockHz  bus clock in Hz, sets the debounce timer count
+// Output: none
+void Switch_Init(uint32_t busClockHz);
+
+//------------Switch_GetEvent------------
+// Take the oldest switch event off the queue, if there is one.
+// Input: event  where to store it
+// Output: 1 if an event was returned, 0 if the queue was empty
+int Switch_GetEvent(SwitchEvent *event);
+
+//------------Switch_Busy------------
+// Whether the switch still needs Timer1A: an edge is being debounced
+// (the PF4 interrupt is disarmed until Timer1A_Handler) or events are
+// waiting. Deep sleep stops Timer1, so only sleep deeply when idle.
+// Input: none
+// Output: non-zero while busy, 0 when idle
+int Switch_Busy(void);
+
+//------------Switch_Dropped------------
+// Number of events lost because the queue was full.
+// Input: none
+// Output: dropped event count
+uint32_t Switch_Dropped(void);
+
+#endif
@@ -0,0 +1,166 @@
+/*
+		File: UART.c
+		Group 17
+		Andrew Nguyen, Anton Tran, Tommy Troung, Abass Mir
+		Functionallity: Implements the busy-wait UART0 output routines
+		and the interrupt-driven receive ring declared in UART.h.
+*/ 
+
+// UART.c
+// Runs on TM4C123
+// Busy-wait device driver for UART0 after the Valvano UART.c examples.
+
+#include <stdint.h>
+#include "UART.h"
+#include "Format.h"
+#include "tm4c123gh6pm.h"
+
+#define UART_FR_TXFF            0x00000020  // UART Transmit FIFO Full
+#define UART_LCRH_WLEN_8        0x00000060  // 8 bit word length
+#define UART_LCRH_FEN           0x00000010  // UART Enable FIFOs
+#define UART_CTL_UARTEN         0x00000001  // UART Enable
+#define PIOSC_HZ                16000000    // precision internal oscillator
+
+static volatile uint8_t RxRing[UART_RX_SIZE];
+static volatile uint32_t RxPutI;        // written only by UART0_Handler
+static volatile uint32_t RxGetI;        // written only by UART_InByte
+static volatile uint32_t RxLinesIn;     // LFs put in the ring, UART0_Handler
+static uint32_t RxLinesOut;             // LFs taken out, UART_InByte
+static uint32_t RxDropped;
+
+// Set the baud rate divisor and frame format; UART0 must be disabled
+static void setBaud(uint32_t clockHz){
+  uint32_t div64;                       // 64 * BaudRateDivisor, rounded
+                                        // BRD = clockHz/(16*baud), 6-bit fraction
+  div64 = (clockHz*4 + UART_BAUD/2)/UART_BAUD;
+  UART0_IBRD_R = div64>>6;              // 80,000,000/(16*115,200) = 43.403
+  UART0_FBRD_R = div64&0x3F;            // 0.403*64 = 26
+                                        // 8 bit word length (no parity bits, one stop bit, FIFOs)
+  UART0_LCRH_R = (UART_LCRH_WLEN_8|UART_LCRH_FEN); // LCRH write latches IBRD and FBRD
+}
+
+//------------UART_Init------------
+// Initialize UART0 for 115200 bps at the given bus clock.
+// Input: busClockHz  bus clock in Hz, Clock_BusHz()
+// Output: none
+void UART_Init(uint32_t busClockHz){
+  SYSCTL_RCGCUART_R |= 0x01;            // activate UART0
+  SYSCTL_RCGCGPIO_R |= 0x01;            // activate port A
+  while((SYSCTL_PRGPIO_R&0x01) == 0){};
+  UART0_CTL_R &= ~UART_CTL_UARTEN;      // disable UART
+  setBaud(busClockHz);
+  UART0_CTL_R |= UART_CTL_UARTEN;       // enable UART
+  GPIO_PORTA_AFSEL_R |= 0x03;           // enable alt funct on PA1-0
+  GPIO_PORTA_DEN_R |= 0x03;             // enable digital I/O on PA1-0
+                                        // configure PA1-0 as UART
+  GPIO_PORTA_PCTL_R = (GPIO_PORTA_PCTL_R&0xFFFFFF00)+0x00000011;
+  GPIO_PORTA_AMSEL_R &= ~0x03;          // disable analog functionality on PA
+}
+
+//------------UART_OutChar------------
+// Output 8-bit to serial port, waits while the transmit FIFO is full
+// Input: letter is an 8-bit ASCII character to be transferred
+// Output: none
+void UART_OutChar(char data){
+  while((UART0_FR_R&UART_FR_TXFF) != 0){};
+  UART0_DR_R = data;
+}
+
+//------------UART_OutString------------
+// Output String (NULL termination)
+// Input: pointer to a NULL-terminated string to be transferred
+// Output: none
+void UART_OutString(char *pt){
+  while(*pt){
+    UART_OutChar(*pt);
+    pt++;
+  }
+}
+
+//------------UART_OutUDec------------
+// Output a 32-bit number in unsigned decimal format
+// Input: 32-bit number to be transferred
+// Output: none
+// Variable format 1-10 digits with no space before or after
+void UART_OutUDec(uint32_t n){
+  char buf[FORMAT_SIZE];
+  Format_UDec(buf, n, 0);
+  UART_OutString(buf);
+}
+
+//------------UART_OutCRLF------------
+// Output a CR,LF to UART to go to a new line
+// Input: none
+// Output: none
+void UART_OutCRLF(void){
+  UART_OutChar(CR);
+  UART_OutChar(LF);
+}
+
+//------------UART_InitRx------------
+// Start receiving into the ring buffer with the UART0 receive
+// interrupts. UART0 is switched to the 16 MHz PIOSC, so it keeps
+// its baud rate in deep sleep and a received byte wakes the core.
+// Call after UART_Init.
+// Input: none
+// Output: none
+void UART_InitRx(void){
+  RxPutI = RxGetI = 0;
+  RxLinesIn = RxLinesOut = 0;
+  RxDropped = 0;
+  while(UART0_FR_R&UART_FR_BUSY){};     // let the last output byte go out
+  UART0_CTL_R &= ~UART_CTL_UARTEN;      // disable UART
+  UART0_CC_R = UART_CC_CS_PIOSC;        // 16,000,000/(16*115,200) = 8.681
+  setBaud(PIOSC_HZ);                    // 0.681*64 = 44
+  UART0_IFLS_R = (UART0_IFLS_R&~UART_IFLS_RX_M)|UART_IFLS_RX4_8;
+  UART0_ICR_R = UART_ICR_RXIC|UART_ICR_RTIC;
+  UART0_IM_R |= UART_IM_RXIM|UART_IM_RTIM; // half full, or quiet for 32 bit times
+  UART0_CTL_R |= UART_CTL_UARTEN;       // enable UART
+  NVIC_PRI1_R = (NVIC_PRI1_R&0xFFFF00FF)|0x00006000; // UART0 is IRQ 5, priority 3
+  NVIC_EN0_R = 1<<5;
+}
+
+// Receive FIFO half full, or bytes waiting and the line went quiet
+void UART0_Handler(void){
+  UART0_ICR_R = UART_ICR_RXIC|UART_ICR_RTIC; // acknowledge both
+  while((UART0_FR_R&UART_FR_RXFE) == 0){
+    uint8_t data = UART0_DR_R;          // error bits dropped
+    if(RxPutI - RxGetI < UART_RX_SIZE){
+      RxRing[RxPutI&(UART_RX_SIZE-1)] = data;
+      RxPutI = RxPutI + 1;              // publish after the byte is written
+      if(data == LF) RxLinesIn = RxLinesIn + 1;
+    } else{
+      RxDropped++;
+    }
+  }
+}
+
+//------------UART_InByte------------
+// Take the oldest received byte out of the ring, if there is one.
+// Input: none
+// Output: the byte (0 to 255), or -1 if the ring is empty
+int UART_InByte(void){
+  uint8_t data;
+  if(RxGetI == RxPutI) return -1;
+  data = RxRing[RxGetI&(UART_RX_SIZE-1)];
+  RxGetI = RxGetI + 1;                  // free the byte after it is read
+  if(data == LF) RxLinesOut = RxLinesOut + 1;
+  return data;
+}
+
+//------------UART_InLines------------
+// Number of complete lines (ending in LF) in the ring, so a parser
+// can take a whole line out without waiting for the rest of it.
+// Input: none
+// Output: complete lines waiting
+uint32_t UART_InLines(void){
+  return RxLinesIn - RxLinesOut;
+}
+
+//------------UART_InDropped------------
+// Number of received bytes lost because the ring was full.
+// Input: none
+// Output: dropped byte count
+uint32_t UART_InDropped(void){
+  return RxDropped;
+}
@@ -0,0 +1,87 @@
+/*
+		File: UART.h
+		Group 17
+		Andrew Nguyen, Anton Tran, Tommy Troung, Abass Mir
+		Functionallity: Declares busy-wait UART0 output routines used
+		to report results to a terminal over the LaunchPad USB port,
+		and the interrupt-driven UART0 receive ring.
+*/ 
+
+// UART.h
+// Runs on TM4C123
+// UART0 on PA1 (U0Tx) and PA0 (U0Rx), 115200 bps, 8 data bits,
+// no parity, one stop bit. PA0/PA1 do not overlap the ST7735 pins.
+// Received bytes are put in a ring buffer by UART0_Handler (one
+// producer) and taken out by the main thread (one consumer), so the
+// ring needs no locking.
+
+#ifndef _UART_H_
+#define _UART_H_
+#include <stdint.h>
+
+#define UART_BAUD 115200
+#define UART_RX_SIZE 256        // receive ring in bytes, must be a power of 2
+
+// standard ASCII symbols
+#define CR   0x0D
+#define LF   0x0A
+
+//------------UART_Init------------
+// Initialize UART0 for 115200 bps at the given bus clock.
+// Input: busClockHz  bus clock in Hz, Clock_BusHz()
+// Output: none
+void UART_Init(uint32_t busClockHz);
+
+//------------UART_OutChar------------
+// Output 8-bit to serial port, waits while the transmit FIFO is full
+// Input: letter is an 8-bit ASCII character to be transferred
+// Output: none
+void UART_OutChar(char data);
+
+//------------UART_OutString------------
+// Output String (NULL termination)
+// Input: pointer to a NULL-terminated string to be transferred
+// Output: none
+void UART_OutString(char *pt);
+
+//------------UART_OutUDec------------
+// Output a 32-bit number in unsigned decimal format
+// Input: 32-bit number to be transferred
+// Output: none
+void UART_OutUDec(uint32_t n);
+
+//------------UART_OutCRLF------------
+// Output a CR,LF to UART to go to a new line
+// Input: none
+// Output: none
+void UART_OutCRLF(void);
+
+//------------UART_InitRx------------
+// Start receiving into the ring buffer with the UART0 receive
+// interrupts. UART0 is switched to the 16 MHz PIOSC, so it keeps
+// its baud rate in deep sleep and a received byte wakes the core.
+// Call after UART_Init.
+// Input: none
+// Output: none
+void UART_InitRx(void);
+
+//------------UART_InByte------------
+// Take the oldest received byte out of the ring, if there is one.
+// Input: none
+// Output: the byte (0 to 255), or -1 if the ring is empty
+int UART_InByte(void);
+
+//------------UART_InLines------------
+// Number of complete lines (ending in LF) in the ring, so a parser
+// can take a whole line out without waiting for the rest of it.
+// Input: none
+// Output: complete lines waiting
+uint32_t UART_InLines(void);
+
+//------------UART_InDropped------------
+// Number of received bytes lost because the ring was full.
+// Input: none
+// Output: dropped byte count
+uint32_t UART_InDropped(void);
+
+#endif
@@ -12,19 +12,32 @@
 // This project displays three different weather screens on an ST7735 LCD.
 // The user can toggle between sunny, cloudy, and rainy screens
 // using the onboard switch SW1 (PF4). Each screen has a unique
-// background, text layout, and animation.
+// background, text layout, and animation. The city and the weather
+// values are updated by a gateway over UART0 (see Gateway updates).
 //
 // Hardware Connections:
 // ST7735 LCD: See ST7735.c for detailed pinout (uses SSI0 on PA2, PA3, PA5 and GPIO on PA6, PA7).
 // Onboard Switch SW1: Connected to PF4.
+// Gateway: UART0 on PA0 (U0Rx) and PA1 (U0Tx), the LaunchPad USB port.
 // Onboard LEDs (optional for debugging): PF1, PF2, PF3.
 
 #include <stdint.h>
 #include <stdlib.h> // For rand()
 #include "ST7735.h"
-#include "bitmaps.h"
+#include "bitmaps_rle.h" // generated from bitmaps.h by rle_icons.py
+#include "Clock.h"
+#include "Scheduler.h"
+#include "Switch.h"
+#include "Power.h"
+#include "UART.h"
+#include "Format.h"
+#include "CycleCount.h"
 #include "tm4c123gh6pm.h"
 
+#if ST7735_PANELS > 3 && !defined(BENCHMARK)
+#error "ST7735 panel 3 uses PF1-PF3, which PortF_Init sets up as the LED outputs"
+#endif
+
 // === Added: centered + scaled bitmap drawing ===
 #ifndef ST7735_TFTWIDTH
 #define ST7735_TFTWIDTH 128
@@ -42,25 +55,37 @@
 #define ICON_CENTER_Y 60  // slightly above middle to avoid bottom text
 #endif
 
-static void DrawBitmapScaledCentered(const uint16_t *img, int w, int h,
-                                     uint16_t bg, int scale){
+// Top-left corner of a w x h icon drawn at the given scale
+static void IconOrigin(int w, int h, int scale, int *left, int *top){
   int scaledW = w * scale;
   int scaledH = h * scale;
-  int left = ICON_CENTER_X - scaledW/2;
-  int top  = ICON_CENTER_Y - scaledH/2;
-  if(left < 0) left = 0;
-  if(top < 0) top = 0;
-  if(left + scaledW > ST7735_TFTWIDTH) left = ST7735_TFTWIDTH - scaledW;
-  if(top  + scaledH > ST7735_TFTHEIGHT) top  = ST7735_TFTHEIGHT - scaledH;
-
-  // Clear previous area (guard band avoids outline artifacts)
-  // Clearing skipped to reduce flicker
-  for(int y = 0; y < h; y++){
-    int srcY = (h - 1 - y); // flip vertically: assets are bottom-up
-    for(int x = 0; x < w; x++){
-      uint16_t c = img[srcY*w + x];
-      ST7735_FillRect(left + x*scale, top + y*scale, scale, scale, c);
-    }
+  *left = ICON_CENTER_X - scaledW/2;
+  *top  = ICON_CENTER_Y - scaledH/2;
+  if(*left < 0) *left = 0;
+  if(*top < 0) *top = 0;
+  if(*left + scaledW > ST7735_TFTWIDTH) *left = ST7735_TFTWIDTH - scaledW;
+  if(*top  + scaledH > ST7735_TFTHEIGHT) *top  = ST7735_TFTHEIGHT - scaledH;
+}
+
+// The icon covers its whole area, so nothing around it is cleared
+static void DrawBitmapScaledCentered(const ST7735_RLEImage *img, int scale){
+  int left, top;
+  IconOrigin(img->w, img->h, scale, &left, &top);
+
+  // One address window for the whole icon, decoded straight to the LCD
+  ST7735_DrawRLEImage(left, top, img, scale);
+}
+
+// Repaints only the pixels that differ between two frames of an icon
+// that is already on the screen (IconDelta tables in bitmaps_rle.h).
+// Each changed run is one 1-row bitmap blit.
+static void ShowIconDelta(const IconDelta *d, int w, int h, int scale){
+  int left, top;
+  IconOrigin(w, h, scale, &left, &top);
+  for(int i = 0; i < d->numSpans; i++){
+    const IconSpan *s = &d->spans[i];
+    ST7735_DrawBitmapScaled(left + s->x*scale, top + s->y*scale,
+                            &d->pixels[s->first], s->len, 1, scale, 0);
   }
 }
 // === End added section ===
@@ -68,57 +93,31 @@ static void DrawBitmapScaledCentered(const uint16_t *img, int w, int h,
 // --- Animation timing ---
 static uint32_t animationFrame = 0;  // global frame counter for animations
 #define ANIMATION_SPEED 10U          // higher = slower blink
-
-// ---- Adapter for migrating from palette icons to raw bitmaps (bitmaps.h) ----
-// New icons are 20x20 pixels each. We'll map the old ICON_*_P structs to these arrays.
-#ifndef ST7735_TFTWIDTH
-#define ST7735_TFTWIDTH 128
-#endif
-
-typedef struct {
-    const unsigned short *idx;   // pointer to 16-bit bitmap data (bitmaps.h)
-    int w;
-    int h;
-    const unsigned short *pal;   // placeholder to keep old signature; unused
-} ICON_P_STUB;
-
-// Unused dummy palette
-static const unsigned short __dummy_pal[1] = {0};
-
-// Map old names to new arrays (20x20)
-static const ICON_P_STUB ICON_SUNNY_P  = { sunny_day, 20, 20, __dummy_pal };
-static const ICON_P_STUB ICON_CLOUDY_P = { cloud_day, 20, 20, __dummy_pal };
-static const ICON_P_STUB ICON_RAINY_P  = { rainy,     20, 20, __dummy_pal };
-
-
-// Shims to keep existing draw calls working
-static inline void DrawBitmap4BPP_Centered(const unsigned short *idx, int w, int h, const unsigned short *pal, int dx, int y) {
-    (void)pal; // unused
-    int x = (ST7735_TFTWIDTH - w)/2 + dx;
-    ST7735_DrawBitmap(x, y, idx, w, h);
-}
-static inline void DrawBitmap4BPP(const unsigned short *idx, int w, int h, const unsigned short *pal, int x, int y) {
-    (void)pal; // unused
-    ST7735_DrawBitmap(x, y, idx, w, h);
-}
-// ---- End adapter ----
+static uint8_t iconShown = 0;        // 0 after a screen redraw: next frame is drawn whole
+static uint32_t iconFrame;           // animation frame currently on the screen
+
+// ---- Icons ----
+// The 20x20 icons are stored run-length encoded over a per-icon
+// palette (ST7735_RLEImage, see bitmaps_rle.h). The raw RGB565
+// arrays in bitmaps.h are only the source for rle_icons.py, which
+// also writes the Icons[] asset table (frames and step deltas of
+// each icon, indexed by IconId). A screen names its icon in its
+// Screens[] entry, so a new condition only needs table entries.
+// ---- End icons ----
 
 // Function Prototypes
 void PortF_Init(void);
-void DelayWait10ms(uint32_t n);
-void drawSunnyScreen(void);
-void drawCloudyScreen(void);
-void drawRainyScreen(void);
-void animateSun(void);
-void animateClouds(void);
-void animateRain(void);
-#define NUM_DROPS 50
+void drawScreen(int state);
+void fieldWidget(int state, int field, ST7735_TextField *w);
+void animateScreen(int state);
+#define NUM_DROPS 60
 
 // Define a state machine for the weather screens
 typedef enum {
     SUNNY,
     CLOUDY,
-    RAINY
+    RAINY,
+    NUM_STATES
 } WeatherState;
 
 // Global variables for animations
@@ -127,211 +126,655 @@ int g_sunRayAngle = 0;
 
 // Cloud animation
 typedef struct {
-    int16_t x, y, w, h, speed;
+    ST7735_Sprite sprite;
+    int16_t speed;
 } Cloud;
 Cloud g_clouds[3];
 
 // Rain animation
 typedef struct {
-    int16_t x, y, speed, len;
+    ST7735_Sprite sprite; // solid 1-pixel wide block, h is the drop length
+    int16_t speed;
 } RainDrop;
-RainDrop g_rainDrops[50];
+RainDrop g_rainDrops[NUM_DROPS];
+
+// --- Moving sprites ---
+// Clouds and rain drops are ST7735 sprites: each frame they are moved
+// and ST7735_UpdateSprites() rebuilds and sends only the rectangles
+// they left and entered. They never cross the icon (x 44-83, y 40-79
+// at ICON_SCALE 2) or the text, which the sprite layer would fill
+// over with the background color.
+#define CLOUD_STEP     4         // animation frames per 1-pixel cloud move
+#define CLOUD_W        28
+#define CLOUD_H        10
+#define CLOUD_COLOR    ST7735_WHITE
+#define CLOUD_KEY      ST7735_BLACK  // transparent corners
+#define RAIN_TOP       26        // rows the drops fall through
+#define RAIN_BOTTOM    81
+#define RAIN_COLOR     ST7735_CYAN
+#define STREAK_TOP     82        // scrolling rain curtain under the icon
+#define STREAK_ROWS    16
+#define STREAK_COLOR   ST7735_BLUE
+
+#ifndef BENCHMARK  // the clouds are set up by main()
+// Clouds are rounded rectangles: rows 0 and h-1 are 3 pixels shorter at
+// each end, rows 1 and h-2 one pixel (the same upside down, so the
+// bottom-up sprite row order does not matter)
+static uint16_t CloudImage[CLOUD_W*CLOUD_H];
+
+static void makeCloudImage(void) {
+  for (int16_t r = 0; r < CLOUD_H; r++) {
+    int16_t in = (r == 0 || r == CLOUD_H - 1) ? 3 : (r == 1 || r == CLOUD_H - 2) ? 1 : 0;
+    for (int16_t c = 0; c < CLOUD_W; c++) {
+      CloudImage[r*CLOUD_W + c] = (c < in || c >= CLOUD_W - in) ? CLOUD_KEY : CLOUD_COLOR;
+    }
+  }
+}
 
+static void initCloud(Cloud *c, int16_t x, int16_t y, int16_t speed) {
+  c->sprite = (ST7735_Sprite){.x = x, .y = y, .w = CLOUD_W, .h = CLOUD_H,
+                              .image = CloudImage, .color = CLOUD_KEY, .visible = 1};
+  c->speed = speed;
+}
+#endif
 
-int main(void) {
-    // Initialization
-    ST7735_InitR(INITR_REDTAB);
-    PortF_Init();
+// Move a cloud by its speed (+-1), wrapping around the screen edges
+static void moveCloud(Cloud *c) {
+  ST7735_Sprite *s = &c->sprite;
+  s->x += c->speed;
+  if (c->speed > 0 && s->x >= ST7735_TFTWIDTH) s->x = -s->w;  // off the right, back in at the left
+  if (c->speed < 0 && s->x + s->w <= 0) s->x = ST7735_TFTWIDTH;
+}
 
-    WeatherState currentState = SUNNY;
-    uint8_t needsRedraw = 1; // Flag to redraw the static screen elements
+// New drop above the band, in the columns left or right of the icon
+static void spawnDrop(RainDrop *d) {
+  d->sprite.x = (rand() % 2) ? (rand() % 40) : (88 + rand() % 40);
+  d->sprite.y = RAIN_TOP - d->sprite.h - (rand() % 40);
+}
 
-    // Initialize cloud positions for animation
-    g_clouds[0] = (Cloud){10, 50, 40, 20, 1};
-    g_clouds[1] = (Cloud){60, 40, 50, 25, -1};
-    g_clouds[2] = (Cloud){-30, 60, 45, 20, 1};
+// Move a drop down by its speed, back to the top once it leaves the band
+static void moveDrop(RainDrop *d) {
+  d->sprite.y += d->speed;
+  if (d->sprite.y > RAIN_BOTTOM) spawnDrop(d);
+}
 
-    // Initialize rain drop positions for animation
-    for (int i = 0; i < 50; i++) {
-        g_rainDrops[i].x = rand() % ST7735_TFTWIDTH;
-        g_rainDrops[i].y = -(rand() % ST7735_TFTHEIGHT); // Start off-screen
-        g_rainDrops[i].speed = (rand() % 3) + 2;
-        g_rainDrops[i].len = (rand() % 4) + 2;
+// Static streaks in the scrolling band; ST7735_Scroll moves them down
+static void drawRainCurtain(void) {
+  for (int16_t k = 0; k < 24; k++) {
+    ST7735_DrawFastVLine((k*37) % ST7735_TFTWIDTH, STREAK_TOP + (k*7) % (STREAK_ROWS - 3),
+                         3, STREAK_COLOR);
+  }
+  ST7735_SetScrollArea(STREAK_TOP, ST7735_TFTHEIGHT - STREAK_TOP - STREAK_ROWS);
+}
+
+
+// --- Weather data ---
+// The city and the numbers on the screens are text fields that the
+// gateway can change (GatewayTask). Each field is a fixed number of
+// character cells, padded with spaces, so a new value repaints
+// exactly the cells of the old one.
+enum WeatherField { CITY, AVG, MAX, MIN, HUMIDITY, NUM_FIELDS };
+#define FIELD_LEN_MAX 10
+static const uint8_t FieldLen[NUM_FIELDS] = {10, 2, 2, 2, 3};
+static char WeatherText[NUM_STATES][NUM_FIELDS][FIELD_LEN_MAX+1] = {
+    {"Carson, CA", "85", "92", "78", " 60"},
+    {"Dallas, TX", "75", "81", "70", " 75"},
+    {"AUSTIN, TX", "68", "72", "65", " 88"},
+};
+
+
+#ifndef BENCHMARK  // the ST7735_Benchmark target has its own main() in Benchmark.c
+// --- Scheduling ---
+// Everything after init runs as periodic tasks on the SysTick tick
+// (Scheduler.c); the CPU sleeps in between.
+#define TICK_HZ        100       // 10 ms tick
+#define INPUT_PERIOD   1         // drain SW1 events every tick
+#define ANIMATE_PERIOD 2         // 50 animation frames a second
+
+static WeatherState currentState = SUNNY;
+static uint8_t needsRedraw = 1; // Flag to redraw the static screen elements
+
+// --- Power ---
+// The unit runs on battery and is almost always idle. Between ticks
+// the core sleeps with the unused clocks gated (Power_Sleep). With no
+// SW1 activity the animation stops and the LCD goes to 8-color idle
+// mode, later it is put to sleep and the core deep-sleeps until SW1.
+// The press that wakes the unit only wakes it, it does not change
+// the screen.
+#define DIM_TICKS      (20*TICK_HZ)  // no input for 20 s: stop animating, LCD idle mode
+#define SLEEP_TICKS    (60*TICK_HZ)  // no input for 60 s: LCD sleep, core deep sleep
+#define POWER_PERIOD   TICK_HZ       // check once a second
+
+typedef enum {
+    AWAKE,
+    DIMMED,
+    ASLEEP
+} PowerState;
+static PowerState powerState = AWAKE;
+static uint32_t lastInput;      // Scheduler_Ticks() at the last SW1 event
+
+// Leaves DIMMED or ASLEEP, returns 1 if the unit was not awake
+static int wakeUp(void) {
+    PowerState was = powerState;
+    if (was == DIMMED) ST7735_SetIdleMode(0);
+    if (was == ASLEEP) ST7735_Wake();
+    powerState = AWAKE;
+    return was != AWAKE;
+}
+
+// Steps down to DIMMED and ASLEEP as the time since the last input grows
+static void PowerTask(void) {
+    uint32_t quiet = Scheduler_Ticks() - lastInput;
+    if (powerState == AWAKE && quiet >= DIM_TICKS) {
+        ST7735_SetIdleMode(1);
+        powerState = DIMMED;
+    } else if (powerState == DIMMED && quiet >= SLEEP_TICKS) {
+        ST7735_Flush();          // nothing may be left for the LCD
+        ST7735_Sleep();
+        powerState = ASLEEP;
     }
+}
 
+// Sleeps between ticks; deep sleep once asleep and SW1 is quiet.
+// Deep sleep stops the ticks, so a gateway line that came in while
+// asleep is first left to GatewayTask: a received byte wakes the
+// core, and once its line is complete the ticks run again until the
+// line is parsed.
+static void IdleSleep(void) {
+    if (powerState == ASLEEP && !Switch_Busy() && !UART_InLines()) {
+        Power_DeepSleep();
+    } else {
+        Power_Sleep();
+    }
+}
 
-    while (1) {
-        // --- Input Handling: Check for SW1 press ---
-        if ((GPIO_PORTF_DATA_R & 0x10) == 0) { // SW1 is pressed
-            DelayWait10ms(2); // Debounce delay
-            if ((GPIO_PORTF_DATA_R & 0x10) == 0) {
-                // Cycle to the next state
-                if (currentState == SUNNY) {
-                    currentState = CLOUDY;
-                } else if (currentState == CLOUDY) {
-                    currentState = RAINY;
-                } else {
-                    currentState = SUNNY;
-                }
-                needsRedraw = 1; // Set flag to redraw the screen
-                while ((GPIO_PORTF_DATA_R & 0x10) == 0) {}; // Wait for switch release
-            }
-        }
+// --- Screen cache ---
+// The first time a screen is shown its static layer (background and
+// text, before the icon) is captured from the framebuffer into
+// ScreenCache; later switches to it are one ST7735_DrawScreen() blit.
+// ScreenCache holds the three layouts as measured with ST7735_Sim.c
+// (724, 787 and 724 bytes); texts from the gateway that need more
+// leave the last screen uncached, drawn from primitives.
+// RAM budget (32 KB): the 20 KB framebuffer, 1.5 KB of palette, the
+// 1 KB uDMA table and this file's sprites and caches leave about 1 KB
+// above the 1 KB stack, so grow nothing here without taking it back
+// elsewhere.
+#define SCREEN_CACHE_BYTES 2240
+static uint8_t ScreenCache[SCREEN_CACHE_BYTES];
+static uint32_t ScreenCacheUsed;
+static const uint8_t *CachedScreen[NUM_STATES]; // by WeatherState, 0 until captured
+
+static void cacheScreen(WeatherState state) {
+    uint32_t n = ST7735_CaptureScreen(&ScreenCache[ScreenCacheUsed],
+                                      SCREEN_CACHE_BYTES - ScreenCacheUsed);
+    if (n) { // 0: no framebuffer or no room, keep drawing this one from primitives
+        CachedScreen[state] = &ScreenCache[ScreenCacheUsed];
+        ScreenCacheUsed += n;
+    }
+}
+
+// Forgets every captured screen, after the text on one changed
+static void uncacheScreens(void) {
+    ScreenCacheUsed = 0;
+    for (int s = 0; s < NUM_STATES; s++) CachedScreen[s] = 0;
+}
 
-        // --- Display Logic ---
-        switch (currentState) {
-            case SUNNY:
-                if (needsRedraw) {
-                    drawSunnyScreen();
-                    needsRedraw = 0;
-                }
-                animateSun();
-                break;
-            case CLOUDY:
-                if (needsRedraw) {
-                    drawCloudyScreen();
-                    needsRedraw = 0;
-                }
-                animateClouds();
-                break;
-            case RAINY:
-                if (needsRedraw) {
-                    drawRainyScreen();
-                    needsRedraw = 0;
-                }
-                animateRain();
-                break;
+// --- Instrumentation ---
+// Built with ST7735_STATS=1, the work of every tick (the tasks from
+// FrameStartTask to FrameEndTask) is timed with the DWT cycle counter
+// into a histogram of FRAME_BUCKETS buckets of FRAME_BUCKET_US each,
+// the last one holding everything longer. The gateway line "?" prints
+// it with the ST7735 counters of each primitive (ST7735_Stats) and
+// starts a new measurement. With ST7735_STATS=0 none of it is built.
+// The printing (about 1 KB, some 90 ms at 115200 bps) is done after
+// the tick's time is taken, and the ticks it drops are not counted as
+// overruns of the next measurement.
+#if ST7735_STATS
+#define FRAME_BUCKETS   16
+#define FRAME_BUCKET_US 250
+static uint32_t FrameHist[FRAME_BUCKETS];
+static uint32_t frameStart, frameMax;   // cycles
+static uint32_t bucketCycles;           // cycles per bucket
+static uint32_t overrunBase;            // Scheduler_Overruns() at the last print
+static uint8_t statsRequested;          // set by the "?" line
+static uint8_t statsPrinted;            // printed at the end of the last tick
+
+// Output n right-aligned in width characters
+static void outNumber(uint32_t n, uint8_t width) {
+    char buf[FORMAT_SIZE];
+    Format_UDec(buf, n, width);
+    UART_OutString(buf);
+}
+
+// Prints and clears the counters, one line per primitive that was
+// used and per histogram bucket that is not empty
+static void printStats(void) {
+    UART_OutString("prim          calls    pixels       cmd      data");
+    UART_OutCRLF();
+    for (uint8_t p = 0; p < ST7735_NUM_PRIMS; p++) {
+        const ST7735_PrimStats *s = ST7735_Stats(p);
+        const char *name = ST7735_PrimName(p);
+        int pad = 12;
+        if (!s->calls && !s->dataBytes) continue;
+        while (*name) {
+            UART_OutChar(*name++);
+            pad--;
         }
-        
-        DelayWait10ms(1); // Control animation speed
+        while (pad-- > 0) UART_OutChar(' ');
+        outNumber(s->calls, 7);
+        outNumber(s->pixels, 10);
+        outNumber(s->cmdBytes, 10);
+        outNumber(s->dataBytes, 10);
+        UART_OutCRLF();
+    }
+    UART_OutString("frame us      ticks");
+    UART_OutCRLF();
+    for (uint32_t b = 0; b < FRAME_BUCKETS; b++) {
+        if (!FrameHist[b]) continue;
+        outNumber(b*FRAME_BUCKET_US, 5);
+        UART_OutString((b < FRAME_BUCKETS - 1) ? " -   " : " +   ");
+        outNumber(FrameHist[b], 9);
+        UART_OutCRLF();
+        FrameHist[b] = 0;
     }
+    UART_OutString("max us ");
+    outNumber(frameMax/(bucketCycles/FRAME_BUCKET_US), 0);
+    UART_OutString(", overruns ");
+    outNumber(Scheduler_Overruns() - overrunBase, 0);
+    UART_OutCRLF();
+    frameMax = 0;
+    ST7735_ClearStats();
 }
 
-// Helper function to draw a string with a specific size and background color
-void DrawStringSizedColor(int16_t x, int16_t y, char *pt, int16_t textColor, int16_t bgColor, uint8_t size) {
-    while(*pt){
-        // Prevent writing past the right edge of the screen
-        if (x > ST7735_TFTWIDTH - 6 * size) break;
-        ST7735_DrawCharS(x, y, *pt, textColor, bgColor, size);
-        pt++;
-        x += 6 * size; // 5 pixels wide font + 1 pixel space
+static void FrameStartTask(void) {
+    if (statsPrinted) {
+        statsPrinted = 0;
+        overrunBase = Scheduler_Overruns(); // including the ticks the printing took
     }
+    frameStart = CycleCount_Now();
 }
 
-// --- Screen Drawing Functions ---
+static void FrameEndTask(void) {
+    uint32_t cycles = CycleCount_Now() - frameStart;
+    uint32_t bucket = cycles/bucketCycles;
+    FrameHist[(bucket < FRAME_BUCKETS) ? bucket : FRAME_BUCKETS - 1]++;
+    if (cycles > frameMax) frameMax = cycles;
+    if (statsRequested) {
+        statsRequested = 0;
+        printStats();
+        statsPrinted = 1;
+    }
+}
+#endif
 
-// Draws the static text and background for the Sunny screen
-void drawSunnyScreen(void) {
-uint16_t bgColor = ST7735_CYAN;
-    ST7735_FillScreen(bgColor);
+// --- Gateway updates ---
+// The gateway sends one field per line on UART0 (115200 bps, 8N1):
+//   <screen><field><value> LF
+//   screen '0' sunny, '1' cloudy, '2' rainy
+//   field  'C' city (up to 10 characters), 'A' average, 'X' maximum and
+//          'N' minimum temperature (-9 to 99), 'H' humidity (0 to 999)
+// for example "1A76" sets the average on the cloudy screen to 76. CR
+// is ignored; bad lines are counted and dropped. In a build with
+// ST7735_STATS=1 the line "?" prints the instrumentation counters
+// (see Instrumentation). UART0_Handler puts
+// the bytes in the UART ring. Once a whole line is in, the value is
+// parsed straight out of the ring into the field text, without a line
+// buffer. On the screen on display a text field widget over each
+// field repaints only the characters that changed, mostly one or two
+// digits (RedrawTask repaints the rest of the screens).
+static const char FieldCode[NUM_FIELDS] = {'C', 'A', 'X', 'N', 'H'};
+static uint8_t fieldsDirty;     // bit f: field f of the screen on display changed
+static ST7735_TextField fieldWidgets[NUM_FIELDS]; // over the fields of the screen on display
+static uint8_t lineDone;        // the LF of the line being parsed was taken
+static uint32_t badLines;
+
+// Next byte of the line being parsed, 0 after its end
+static int lineByte(void) {
+    int c;
+    if (lineDone) return 0;
+    do {
+        c = UART_InByte();
+    } while (c == CR);
+    if (c == LF || c < 0) {
+        lineDone = 1;
+        return 0;
+    }
+    return c;
+}
 
-    DrawStringSizedColor(4, 10, "Carson, CA", ST7735_YELLOW, bgColor, 2);
-    DrawStringSizedColor(5, 100, "Avg:85 Max:92 Min:78", ST7735_GREEN, bgColor, 1);
-    DrawStringSizedColor(35,110, "Humidity: 60%",        ST7735_GREEN, bgColor, 1);
-    DrawStringSizedColor(19,130, "CLEAR",                ST7735_WHITE, bgColor, 3);
+// Stores a character of a field, returns 1 if it was different
+static int putField(char *text, int i, char c) {
+    if (text[i] == c) return 0;
+    text[i] = c;
+    return 1;
+}
 
-   
+// Left-aligned text up to the end of the line, padded with spaces
+static int parseText(char *text, int len) {
+    int changed = 0;
+    for (int i = 0; i < len; i++) {
+        int c = lineByte();
+        changed |= putField(text, i, (c >= ' ' && c <= '~') ? c : ' ');
+    }
+    return changed;
 }
 
-// Draws the static text and background for the Cloudy screen
-void drawCloudyScreen(void) {
-uint16_t bgColor = ST7735_LIGHTGREY;
-    ST7735_FillScreen(bgColor);
+// Decimal number up to the end of the line, right-aligned; -1 if it
+// is not a number or does not fit, the field is then left as it was
+static int parseNumber(char *text, int len) {
+    int changed = 0, negative = 0, digits = 0;
+    int32_t n = 0;
+    char number[FORMAT_SIZE];
+    int c = lineByte();
+    if (c == '-') {
+        negative = 1;
+        c = lineByte();
+    }
+    while (c >= '0' && c <= '9') {
+        if (n < 100000) n = 10*n + (c - '0');
+        digits++;
+        c = lineByte();
+    }
+    if (c != 0 || digits == 0) return -1;
+    if (Format_Dec(number, negative ? -n : n, len) > (uint32_t)len) return -1; // no leading zeros
+    for (int i = 0; i < len; i++) changed |= putField(text, i, number[i]);
+    return changed;
+}
 
-    DrawStringSizedColor(4, 10, "Dallas, TX", ST7735_DARKGREY, bgColor, 2);
-    DrawStringSizedColor(5, 100, "Avg:75 Max:81 Min:70", ST7735_BLUE, bgColor, 1);
-    DrawStringSizedColor(35,110, "Humidity: 75%",        ST7735_BLUE, bgColor, 1);
-    DrawStringSizedColor(10,130, "CLOUDY",               ST7735_WHITE, bgColor, 3);
+// Takes one complete line out of the UART ring and applies it
+static void parseLine(void) {
+    int screen, code, field = NUM_FIELDS, changed = -1;
+    lineDone = 0;
+    screen = lineByte();
+#if ST7735_STATS
+    if (screen == '?') {
+        while (lineByte()) {};
+        statsRequested = 1;             // printed by FrameEndTask
+        return;
+    }
+#endif
+    screen = screen - '0';
+    code = lineByte();
+    for (int f = 0; f < NUM_FIELDS; f++) {
+        if (code == FieldCode[f]) {
+            field = f;
+            break;
+        }
+    }
+    if (screen >= 0 && screen < NUM_STATES && field < NUM_FIELDS) {
+        char *text = WeatherText[screen][field];
+        changed = (field == CITY) ? parseText(text, FieldLen[field])
+                                  : parseNumber(text, FieldLen[field]);
+    }
+    while (lineByte()) {}; // rest of a long or bad line
+    if (changed < 0) {      // also a short line or an unknown field code
+        badLines++;
+    } else if (changed) {
+        uncacheScreens();
+        if (screen == (int)currentState) fieldsDirty |= 1 << field;
+    }
+}
 
-   
+// Applies the lines received from the gateway
+static void GatewayTask(void) {
+    while (UART_InLines()) parseLine();
+    if (!fieldsDirty || needsRedraw) return;   // a redraw paints all fields
+    if (powerState == ASLEEP) return;          // repainted after waking
+    for (int f = 0; f < NUM_FIELDS; f++) {
+        if (fieldsDirty & (1 << f)) {
+            ST7735_UpdateTextField(&fieldWidgets[f], WeatherText[currentState][f]);
+        }
+    }
+    fieldsDirty = 0;
 }
 
-// Draws the static text and background for the Rainy screen
-void drawRainyScreen(void) {
-uint16_t bgColor = ST7735_DARKBLUE;
-    ST7735_FillScreen(bgColor); 
+// Handles the debounced SW1 events queued by Switch.c
+static void InputTask(void) {
+    SwitchEvent event;
+    while (Switch_GetEvent(&event)) {
+        lastInput = Scheduler_Ticks();
+        if (event != SW1_PRESS) continue;
+        if (wakeUp()) continue; // this press only wakes the unit
+        currentState = (currentState + 1) % NUM_STATES; // Cycle to the next state
+        needsRedraw = 1; // Set flag to redraw the screen
+    }
+}
 
-    DrawStringSizedColor(4, 10,  "AUSTIN, TX",            ST7735_LIGHTGREY, bgColor, 2);
-    DrawStringSizedColor(5, 100, "Avg:68 Max:72 Min:65",  ST7735_YELLOW,    bgColor, 1);
-    DrawStringSizedColor(35,110, "Humidity: 88%",         ST7735_YELLOW,    bgColor, 1);
-    DrawStringSizedColor(19,130, "RAINY",                 ST7735_CYAN,      bgColor, 3);
+// Draws the static screen after a state change
+static void RedrawTask(void) {
+    if (!needsRedraw) return;
+    ST7735_SetScrollArea(0, 0); // undo the rain curtain scrolling
+    if (CachedScreen[currentState]) {
+        ST7735_DrawScreen(CachedScreen[currentState]);
+        iconShown = 0;
+    } else {
+        drawScreen(currentState);
+        cacheScreen(currentState);
+    }
+    for (int f = 0; f < NUM_FIELDS; f++) fieldWidget(currentState, f, &fieldWidgets[f]);
+    fieldsDirty = 0;
+    needsRedraw = 0;
+}
 
-   
+// Advances the animation of the current screen by one frame
+static void AnimateTask(void) {
+    if (powerState != AWAKE) return; // the screen stays as it is
+    animateScreen(currentState);
 }
 
+// Sends what changed this tick to the LCD
+static void FlushTask(void) {
+    ST7735_Flush();
+}
+
+int main(void) {
+    // Initialization
+    Clock_Init(Bus80MHz); // first: the drivers below derive their rates from Clock_BusHz()
+    ST7735_StartInitR(INITR_REDTAB); // the LCD comes up in the background; drawing on it waits
+    ST7735_SetFramebuffer(1); // compose each frame in RAM, send it with ST7735_Flush()
+    PortF_Init();
+    Switch_Init(Clock_BusHz()); // SW1 press/release events from the PF4 interrupt
+    UART_Init(Clock_BusHz());
+    UART_InitRx();              // weather updates from the gateway (GatewayTask)
+
+    // Initialize cloud positions for animation: two above the icon
+    // (same speed, so they never overlap), one below it
+    makeCloudImage();
+    initCloud(&g_clouds[0], 10, 28, 1);
+    initCloud(&g_clouds[1], 60, 86, -1);
+    initCloud(&g_clouds[2], -60, 28, 1);
+
+    // Initialize rain drop sizes; positions are set when the screen is shown
+    for (int i = 0; i < NUM_DROPS; i++) {
+        uint8_t len = (rand() % 4) + 2;
+        g_rainDrops[i].sprite = (ST7735_Sprite){.w = 1, .h = len, .color = RAIN_COLOR, .visible = 1};
+        g_rainDrops[i].speed = (rand() % 3) + 2;
+    }
+
+    // Tasks of one tick run in this order
+    Scheduler_Init(Clock_BusHz(), TICK_HZ);
+#if ST7735_STATS
+    CycleCount_Init();
+    bucketCycles = Clock_BusHz()/1000000*FRAME_BUCKET_US;
+    Scheduler_AddTask(FrameStartTask, 1);
+#endif
+    Scheduler_AddTask(InputTask, INPUT_PERIOD);
+    Scheduler_AddTask(GatewayTask, 1);
+    Scheduler_AddTask(RedrawTask, 1);
+    Scheduler_AddTask(AnimateTask, ANIMATE_PERIOD);
+    Scheduler_AddTask(FlushTask, 1);
+#if ST7735_STATS
+    Scheduler_AddTask(FrameEndTask, 1);
+#endif
+    Scheduler_AddTask(PowerTask, POWER_PERIOD);
+    Power_Init(); // last: the clocks it keeps in sleep are the ones set up above
+    Scheduler_SetIdle(IdleSleep);
+    Scheduler_Run(); // never returns
+}
+#endif
+
+// Helper function to draw a string with a specific size and background color
+void DrawStringSizedColor(int16_t x, int16_t y, char *pt, int16_t textColor, int16_t bgColor, uint8_t size) {
+    // One address window for the whole label; stops before the right edge of the screen
+    ST7735_DrawText(x, y, pt, textColor, bgColor, size);
+}
+
+// --- Screen Drawing Functions ---
+// Each static screen is a display list: the background fill, the
+// fields (in WeatherField order, so FIELD_OP(f) is the entry of
+// field f), then the labels. ST7735_DrawList() draws it into the framebuffer, or,
+// in a build without one, renders it in bands so the LCD never
+// shows the fill wiping down the screen before the text.
+#define SCREEN_FILL(color)         {ST7735_OP_FILLRECT, 0, 0, 0, ST7735_TFTWIDTH, ST7735_TFTHEIGHT, color, 0, 0}
+#define SCREEN_TEXT(x, y, str, color, bg, size) {ST7735_OP_TEXT, size, x, y, 0, 0, color, bg, str}
+#define SCREEN_OPS(list)           (sizeof(list)/sizeof(list[0]))
+#define FIELD_OP(f)                (1 + (f))
+// Fields and labels of one screen; at size 1 a character cell is 6 pixels wide
+#define SCREEN_FIELDS(state, cityColor, color, bg) \
+    SCREEN_TEXT(4,  10,  WeatherText[state][CITY],     cityColor, bg, 2), \
+    SCREEN_TEXT(29, 100, WeatherText[state][AVG],      color, bg, 1), \
+    SCREEN_TEXT(71, 100, WeatherText[state][MAX],      color, bg, 1), \
+    SCREEN_TEXT(113,100, WeatherText[state][MIN],      color, bg, 1), \
+    SCREEN_TEXT(89, 110, WeatherText[state][HUMIDITY], color, bg, 1), \
+    SCREEN_TEXT(5,  100, "Avg:",      color, bg, 1), \
+    SCREEN_TEXT(41, 100, " Max:",     color, bg, 1), \
+    SCREEN_TEXT(83, 100, " Min:",     color, bg, 1), \
+    SCREEN_TEXT(35, 110, "Humidity:", color, bg, 1), \
+    SCREEN_TEXT(107,110, "%",         color, bg, 1)
+
+static const ST7735_DrawOp SunnyScreen[] = {
+    SCREEN_FILL(ST7735_CYAN),
+    SCREEN_FIELDS(SUNNY, ST7735_YELLOW, ST7735_GREEN, ST7735_CYAN),
+    SCREEN_TEXT(19,130, "CLEAR",                ST7735_WHITE,  ST7735_CYAN, 3),
+};
+
+static const ST7735_DrawOp CloudyScreen[] = {
+    SCREEN_FILL(ST7735_LIGHTGREY),
+    SCREEN_FIELDS(CLOUDY, ST7735_DARKGREY, ST7735_BLUE, ST7735_LIGHTGREY),
+    SCREEN_TEXT(10,130, "CLOUDY",               ST7735_WHITE,    ST7735_LIGHTGREY, 3),
+};
+
+static const ST7735_DrawOp RainyScreen[] = {
+    SCREEN_FILL(ST7735_DARKBLUE),
+    SCREEN_FIELDS(RAINY, ST7735_LIGHTGREY, ST7735_YELLOW, ST7735_DARKBLUE),
+    SCREEN_TEXT(19,130, "RAINY",                ST7735_CYAN,      ST7735_DARKBLUE, 3),
+};
+
 // --- Animation Functions ---
-void UpdateSunnyAnimation(void);
-void UpdateRainyAnimation(void);
-void UpdateCloudyAnimation(void);
-void animateSun(void){ UpdateSunnyAnimation(); }
+// Registers the clouds over a freshly drawn cloudy screen
+static void enterClouds(void){
+  for (int i = 0; i < 3; i++) (void)ST7735_AddSprite(&g_clouds[i].sprite);
+}
 
-void animateClouds(void){ UpdateCloudyAnimation(); }
+// Drifts the clouds above and below the icon
+static void stepClouds(void){
+  for (int i = 0; i < 3; i++) moveCloud(&g_clouds[i]);
+}
 
-// Animates a rotating sun for the sunny screen
-void UpdateSunnyAnimation(void) {
-  static uint32_t prevBlink = 0xFFFFFFFF; // sentinel
-  animationFrame++;
-  uint32_t showBlink = (animationFrame / ANIMATION_SPEED) % 2;
-  if(showBlink != prevBlink) {
-    const uint16_t *icon = showBlink ? sunny_day_blink : sunny_day;
-    DrawBitmapScaledCentered(icon, 20, 20, ST7735_CYAN, ICON_SCALE);
-    prevBlink = showBlink;
+// Drops start above the band again, the curtain under the icon is redrawn
+static void enterRain(void){
+  for (int i = 0; i < NUM_DROPS; i++) {
+    spawnDrop(&g_rainDrops[i]);
+    (void)ST7735_AddSprite(&g_rainDrops[i].sprite);
   }
-  DelayWait10ms(1);
+  drawRainCurtain();
 }
 
-// Helper function to draw a cloud
-void UpdateCloudyAnimation(void) {
-  static uint32_t prevBlink = 0xFFFFFFFF; // sentinel
-  animationFrame++;
-  uint32_t showBlink = (animationFrame / ANIMATION_SPEED) % 2;
-  if(showBlink != prevBlink) {
-    const uint16_t *icon = showBlink ? cloud_day_blink : cloud_day;
-    DrawBitmapScaledCentered(icon, 20, 20, ST7735_LIGHTGREY, ICON_SCALE);
-    prevBlink = showBlink;
-  }
-  DelayWait10ms(1);
+// Animates falling rain
+static void stepRain(void){
+  for (int i = 0; i < NUM_DROPS; i++) moveDrop(&g_rainDrops[i]);
+  ST7735_Scroll(animationFrame); // 3 bytes move the whole curtain one row
 }
 
-// Animates drifting clouds
-void UpdateRainyAnimation(void) {
-  static uint32_t prevBlink = 0xFFFFFFFF; // sentinel
-  animationFrame++;
-  uint32_t showBlink = (animationFrame / ANIMATION_SPEED) % 2;
-  if(showBlink != prevBlink) {
-    const uint16_t *icon = showBlink ? rainy_blink : rainy;
-    DrawBitmapScaledCentered(icon, 20, 20, ST7735_DARKBLUE, ICON_SCALE);
-    prevBlink = showBlink;
-  }
-  DelayWait10ms(1);
+// --- Screen table ---
+// Everything that differs between the weather screens is in one
+// ScreenDef per WeatherState: the display list of the static layer,
+// the icon and the color behind it, the region its sprites move in
+// and the hooks that animate them. drawScreen() and animateScreen()
+// only index the table, so a new screen is a new WeatherState and a
+// new entry, with no new case in the tasks.
+typedef struct {
+    const ST7735_DrawOp *layout;   // static layer: background, fields, labels
+    uint8_t numOps;
+    uint8_t icon;                  // IconId
+    uint16_t bg;                   // color behind the icon and the sprites
+    int16_t x, y, w, h;            // active region of the sprites, w 0 for none
+    void (*enter)(void);           // adds the sprites after a redraw, or 0
+    void (*step)(void);            // moves them, or 0 for a screen without sprites
+    uint8_t period;                // animation frames per step
+} ScreenDef;
+
+static const ScreenDef Screens[NUM_STATES] = {
+    {SunnyScreen,  SCREEN_OPS(SunnyScreen),  ICON_SUNNY_DAY, ST7735_CYAN,
+     0, 0, 0, 0, 0, 0, 1},
+    {CloudyScreen, SCREEN_OPS(CloudyScreen), ICON_CLOUD_DAY, ST7735_LIGHTGREY,
+     0, 0, ST7735_TFTWIDTH, ST7735_TFTHEIGHT, enterClouds, stepClouds, CLOUD_STEP},
+    {RainyScreen,  SCREEN_OPS(RainyScreen),  ICON_RAINY,     ST7735_DARKBLUE,
+     0, RAIN_TOP, ST7735_TFTWIDTH, RAIN_BOTTOM - RAIN_TOP + 1, enterRain, stepRain, 1},
+};
+
+// Sets up a text field widget over a field as its display list draws it
+void fieldWidget(int state, int field, ST7735_TextField *w) {
+    const ST7735_DrawOp *op = &Screens[state].layout[FIELD_OP(field)];
+    w->x = op->x;
+    w->y = op->y;
+    w->len = FieldLen[field];
+    w->size = op->size;
+    w->color = op->color;
+    w->bgColor = op->bgColor;
+    ST7735_SetTextFieldShown(w, op->data);
 }
 
-// Draws only the text overlay for the Rainy screen (no screen clear)
-static void drawRainyOverlayText(void) {
-    uint16_t bgColor = ST7735_DARKBLUE;
-    DrawStringSizedColor(4, 10,  "AUSTIN, TX",            ST7735_LIGHTGREY, bgColor, 2);
-    DrawStringSizedColor(5, 100, "Avg:68 Max:72 Min:65",  ST7735_YELLOW,    bgColor, 1);
-    DrawStringSizedColor(35,110, "Humidity: 88%",         ST7735_YELLOW,    bgColor, 1);
-    DrawStringSizedColor(19,130, "RAINY",                 ST7735_CYAN,      bgColor, 3);
+// Draws the static text and background of a screen; the next
+// animation frame draws its icon and sprites over it
+void drawScreen(int state) {
+    ST7735_DrawList(Screens[state].layout, Screens[state].numOps);
+    iconShown = 0;
 }
-// Animates falling rain
-void animateRain(void) {
-  static uint32_t prevBlink = 0xFFFFFFFF; // sentinel
+
+// Frame animation shared by the screens. The first frame after a
+// screen redraw is drawn whole, after that each step to the next frame
+// only sends the pixels that change (icon->toNext). Frames where the
+// icon stays as it is cost nothing.
+static void AnimateIcon(const IconAsset *icon){
+  uint32_t frame = (animationFrame / ANIMATION_SPEED) % icon->numFrames;
+  if(!iconShown) {
+    DrawBitmapScaledCentered(icon->frames[frame], ICON_SCALE);
+    iconShown = 1;
+  } else if(frame != iconFrame) {
+    if(frame == (iconFrame + 1) % icon->numFrames) {
+      ShowIconDelta(icon->toNext[iconFrame], icon->w, icon->h, ICON_SCALE);
+    } else {
+      DrawBitmapScaledCentered(icon->frames[frame], ICON_SCALE);
+    }
+  }
+  iconFrame = frame;
+}
+
+// Advances the animation of a screen by one frame. After a redraw its
+// sprites are registered in its active region; after that they are
+// moved and sent only on the frames its period makes due, so only
+// the rectangles they left and entered reach the LCD.
+void animateScreen(int state) {
+  const ScreenDef *s = &Screens[state];
   animationFrame++;
-  uint32_t showBlink = (animationFrame / ANIMATION_SPEED) % 2;
-  if(showBlink != prevBlink) {
-    const uint16_t *icon = showBlink ? rainy_blink : rainy;
-    DrawBitmapScaledCentered(icon, 20, 20, ST7735_DARKBLUE, ICON_SCALE);
-    prevBlink = showBlink;
+  if (!iconShown) {
+    ST7735_ClearSprites();
+    if (s->w) ST7735_SetSpriteArea(s->x, s->y, s->w, s->h, s->bg);
+    if (s->enter) s->enter();
+    ST7735_UpdateSprites();
+  } else if (s->step && animationFrame % s->period == 0) {
+    s->step();
+    ST7735_UpdateSprites();
   }
-  DelayWait10ms(1);
+  AnimateIcon(&Icons[s->icon]);
 }
 
 
 
 // --- Hardware Initialization and Utilities ---
 
-// Initializes Port F for SW1 input
+// Initializes Port F for SW1 input and the LEDs (SW1 interrupt: Switch_Init)
 void PortF_Init(void) {
     SYSCTL_RCGCGPIO_R |= 0x20; // 1) activate clock for Port F
     while ((SYSCTL_PRGPIO_R & 0x20) == 0) {}; // allow time for clock to start
@@ -344,15 +787,3 @@ void PortF_Init(void) {
     GPIO_PORTF_PUR_R = 0x11;    // enable pull-up on PF0 and PF4
     GPIO_PORTF_DEN_R = 0x1F;    // 7) enable digital I/O on PF4-0
 }
-
-// Simple delay function
-void DelayWait10ms(uint32_t n) {
-    uint32_t volatile time;
-    while (n) {
-        time = 727240 / 91; // 10msec
-        while (time) {
-            time--;
-        }
-        n--;
-    }
-}
@@ -0,0 +1,530 @@
+/*
+		File: bitmaps_rle.h
+		Group 17
+		Andrew Nguyen, Anton Tran, Tommy Troung, Abass Mir
+		Functionallity: Run-length encoded, palette-indexed versions
+		of the weather icons in bitmaps.h for ST7735_DrawRLEImage().
+		Generated by rle_icons.py -- do not edit by hand.
+*/ 
+
+// 4800 bytes raw RGB565, 1845 bytes encoded (palettes included)
+
+#ifndef __BITMAPS_RLE_H__
+#define __BITMAPS_RLE_H__
+#include <stdint.h>
+#include "ST7735.h"
+
+static const uint16_t cloud_day_pal[] = {
+ 0xE71A, 0xBBA1, 0xDEB9, 0xD658, 0xE6D9, 0xD637, 0xDE98, 0xC425,
+ 0xCDD4, 0xD5F5, 0xE6F9, 0xBBA2, 0xBBC2, 0xBBE3, 0xBBE4, 0xC4CB,
+ 0xCDB3, 0xD616, 0xDE78, 0xDED9, 0xBBC3, 0xC405, 0xC489, 0xC4AB,
+ 0xCCA9, 0xCCCA, 0xCD0B, 0xCD0C, 0xCD2C, 0xCD4D, 0xCD50, 0xCD70,
+ 0xCD71, 0xCD91, 0xD5B0, 0xD5D1, 0xD5D3, 0xD5D4, 0xE6B7, 0xE6B8,
+ 0xE6DA, 0xE6FA,
+};
+
+static const uint8_t cloud_day_rle[] = {
+ 0x87, 0x01, 0x03, 0x17, 0x10, 0x10, 0x16, 0x8E, 0x01, 0x05, 0x0F, 0x03, 0x02, 0x02, 0x03, 0x0F,
+ 0x8C, 0x01, 0x01, 0x09, 0x28, 0x83, 0x00, 0x01, 0x04, 0x08, 0x8B, 0x01, 0x00, 0x04, 0x85, 0x00,
+ 0x00, 0x13, 0x88, 0x01, 0x02, 0x0E, 0x0B, 0x08, 0x87, 0x00, 0x02, 0x20, 0x0C, 0x0E, 0x84, 0x01,
+ 0x03, 0x1E, 0x11, 0x09, 0x02, 0x87, 0x00, 0x03, 0x06, 0x09, 0x11, 0x1F, 0x82, 0x01, 0x00, 0x08,
+ 0x85, 0x00, 0x03, 0x05, 0x03, 0x03, 0x05, 0x85, 0x00, 0x03, 0x21, 0x01, 0x0C, 0x02, 0x84, 0x00,
+ 0x05, 0x02, 0x04, 0x00, 0x00, 0x04, 0x04, 0x84, 0x00, 0x02, 0x02, 0x14, 0x25, 0x83, 0x00, 0x02,
+ 0x02, 0x06, 0x12, 0x83, 0x00, 0x02, 0x03, 0x06, 0x02, 0x83, 0x00, 0x01, 0x24, 0x02, 0x82, 0x00,
+ 0x02, 0x02, 0x05, 0x03, 0x84, 0x00, 0x03, 0x29, 0x03, 0x05, 0x02, 0x82, 0x00, 0x00, 0x13, 0x83,
+ 0x00, 0x00, 0x06, 0x89, 0x00, 0x00, 0x12, 0xAB, 0x00, 0x00, 0x27, 0x91, 0x00, 0x01, 0x0A, 0x15,
+ 0x91, 0x00, 0x01, 0x07, 0x01, 0x90, 0x00, 0x03, 0x0A, 0x01, 0x01, 0x0B, 0x82, 0x00, 0x00, 0x23,
+ 0x87, 0x00, 0x00, 0x22, 0x82, 0x00, 0x83, 0x01, 0x04, 0x0D, 0x18, 0x07, 0x01, 0x0A, 0x85, 0x00,
+ 0x04, 0x26, 0x01, 0x07, 0x19, 0x0D, 0x88, 0x01, 0x00, 0x1D, 0x83, 0x00, 0x00, 0x1B, 0x8E, 0x01,
+ 0x03, 0x1A, 0x04, 0x04, 0x1C, 0x87, 0x01,
+};
+
+static const ST7735_RLEImage cloud_day_img = {
+  20, 20, 8, 42, cloud_day_pal, cloud_day_rle
+};
+
+static const uint16_t cloud_day_blink_pal[] = {
+ 0xE71A, 0xBBA1, 0xE6FA, 0xDEB9, 0xD637, 0xDE78, 0xBBA2, 0xD678,
+ 0xDE98, 0xC426, 0xD658, 0xBBC2, 0xD5B0, 0xDE99, 0xE6D8, 0xE6D9,
+ 0xE6F9, 0xBC05, 0xC404, 0xC446, 0xCD70, 0xCDF5, 0xD5F2, 0xD635,
+ 0xDE96, 0xDED9, 0xBBE3, 0xBBE4, 0xC3E4, 0xC425, 0xC448, 0xC4AA,
+ 0xCCEA, 0xCD0B, 0xCD2C, 0xCD2E, 0xCDD4, 0xD54E, 0xD58F, 0xD5F5,
+ 0xD615, 0xD616, 0xD636, 0xD656, 0xD657, 0xDE57, 0xDE76, 0xDE77,
+ 0xDE97, 0xDEB7,
+};
+
+static const uint8_t cloud_day_blink_rle[] = {
+ 0x83, 0x01, 0x0C, 0x29, 0x27, 0x01, 0x01, 0x09, 0x15, 0x15, 0x09, 0x01, 0x01, 0x24, 0x2A, 0x06,
+ 0x85, 0x01, 0x0D, 0x2B, 0x00, 0x00, 0x09, 0x11, 0x04, 0x03, 0x03, 0x04, 0x11, 0x1E, 0x00, 0x00,
+ 0x2F, 0x83, 0x01, 0x06, 0x14, 0x17, 0x00, 0x03, 0x0F, 0x0A, 0x10, 0x83, 0x00, 0x0E, 0x10, 0x07,
+ 0x0F, 0x03, 0x00, 0x2D, 0x14, 0x06, 0x1B, 0x02, 0x00, 0x00, 0x03, 0x05, 0x03, 0x85, 0x00, 0x0C,
+ 0x08, 0x07, 0x19, 0x00, 0x00, 0x02, 0x09, 0x2E, 0x00, 0x05, 0x03, 0x02, 0x08, 0x87, 0x00, 0x0B,
+ 0x03, 0x02, 0x0D, 0x05, 0x00, 0x02, 0x18, 0x00, 0x05, 0x04, 0x04, 0x05, 0x82, 0x00, 0x81, 0x02,
+ 0x82, 0x00, 0x07, 0x05, 0x04, 0x04, 0x08, 0x00, 0x00, 0x0C, 0x0D, 0x85, 0x00, 0x03, 0x04, 0x07,
+ 0x07, 0x04, 0x84, 0x00, 0x04, 0x02, 0x0D, 0x0C, 0x01, 0x05, 0x84, 0x00, 0x05, 0x02, 0x03, 0x00,
+ 0x00, 0x03, 0x02, 0x84, 0x00, 0x02, 0x05, 0x1A, 0x23, 0x83, 0x00, 0x02, 0x03, 0x08, 0x0A, 0x83,
+ 0x00, 0x02, 0x2C, 0x08, 0x19, 0x83, 0x00, 0x01, 0x1F, 0x17, 0x82, 0x00, 0x03, 0x0F, 0x04, 0x0A,
+ 0x02, 0x83, 0x00, 0x03, 0x10, 0x07, 0x04, 0x02, 0x82, 0x00, 0x01, 0x28, 0x0E, 0x82, 0x00, 0x00,
+ 0x05, 0x89, 0x00, 0x00, 0x0A, 0x82, 0x00, 0x01, 0x02, 0x0E, 0x82, 0x00, 0x00, 0x02, 0x89, 0x00,
+ 0x00, 0x02, 0x83, 0x00, 0x00, 0x31, 0x91, 0x00, 0x01, 0x0E, 0x0C, 0x91, 0x00, 0x01, 0x22, 0x06,
+ 0x91, 0x00, 0x02, 0x0B, 0x01, 0x26, 0x8F, 0x00, 0x00, 0x25, 0x82, 0x01, 0x03, 0x30, 0x00, 0x02,
+ 0x16, 0x87, 0x00, 0x03, 0x16, 0x00, 0x00, 0x18, 0x84, 0x01, 0x03, 0x1C, 0x0B, 0x01, 0x21, 0x85,
+ 0x00, 0x03, 0x20, 0x01, 0x0B, 0x12, 0x89, 0x01, 0x00, 0x13, 0x83, 0x00, 0x00, 0x1D, 0x8E, 0x01,
+ 0x03, 0x06, 0x13, 0x12, 0x06, 0x87, 0x01,
+};
+
+static const ST7735_RLEImage cloud_day_blink_img = {
+  20, 20, 8, 50, cloud_day_blink_pal, cloud_day_blink_rle
+};
+
+static const uint16_t sunny_day_pal[] = {
+ 0xBBA1, 0x1D9D, 0x0E7E, 0x1DDD, 0x163E, 0x165E, 0x1DBD, 0x1DFE,
+ 0x1E1E, 0x0E9E, 0x255D, 0x257D, 0x253C, 0x0EBF, 0x1DFD, 0xABC4,
+ 0xABE4, 0x06BF, 0x161E, 0x255C, 0xB3C3, 0xBBA2, 0x0E5E, 0x1D7D,
+ 0x8C6A, 0xB3C4, 0x0E9F, 0x1E3B, 0x1E5C, 0x24DC, 0x251C, 0x25FB,
+ 0x2CDC, 0x2DF9, 0x2E39, 0x3519, 0x353A, 0x3559, 0x3D38, 0x3D97,
+ 0x3DB7, 0x4536, 0x4CF5, 0x4D36, 0x54D3, 0x5C53, 0x5D31, 0x5D51,
+ 0x64F0, 0x6CB0, 0x742E, 0x746E, 0x7C4D, 0x7C6D, 0x8C4A, 0x8C8A,
+ 0x9447, 0x9BE7, 0x9C07, 0xA3C5, 0xA3E5, 0xA406, 0xABE5, 0xB3A2,
+};
+
+static const uint8_t sunny_day_rle[] = {
+ 0x8B, 0x00, 0x01, 0x09, 0x2F, 0x8A, 0x00, 0x01, 0x1B, 0x10, 0x84, 0x00, 0x01, 0x05, 0x02, 0x8A,
+ 0x00, 0x02, 0x31, 0x07, 0x3F, 0x82, 0x00, 0x02, 0x35, 0x01, 0x14, 0x8B, 0x00, 0x06, 0x01, 0x3D,
+ 0x0F, 0x18, 0x36, 0x19, 0x34, 0x8C, 0x00, 0x07, 0x2B, 0x05, 0x09, 0x0D, 0x0D, 0x11, 0x0D, 0x1F,
+ 0x8A, 0x00, 0x00, 0x10, 0x82, 0x02, 0x81, 0x09, 0x0F, 0x1A, 0x0D, 0x11, 0x38, 0x00, 0x14, 0x21,
+ 0x22, 0x00, 0x18, 0x11, 0x15, 0x00, 0x30, 0x04, 0x04, 0x82, 0x05, 0x82, 0x02, 0x81, 0x09, 0x0A,
+ 0x1C, 0x0B, 0x06, 0x00, 0x00, 0x25, 0x07, 0x05, 0x2E, 0x08, 0x08, 0x82, 0x04, 0x82, 0x05, 0x82,
+ 0x02, 0x00, 0x09, 0x85, 0x00, 0x08, 0x0F, 0x00, 0x03, 0x0E, 0x07, 0x07, 0x08, 0x08, 0x12, 0x82,
+ 0x04, 0x81, 0x05, 0x86, 0x00, 0x00, 0x3E, 0x82, 0x03, 0x05, 0x0E, 0x07, 0x07, 0x08, 0x08, 0x12,
+ 0x82, 0x04, 0x86, 0x00, 0x01, 0x0F, 0x01, 0x82, 0x06, 0x82, 0x03, 0x04, 0x0E, 0x07, 0x07, 0x08,
+ 0x08, 0x87, 0x00, 0x83, 0x01, 0x81, 0x06, 0x82, 0x03, 0x02, 0x0E, 0x07, 0x07, 0x86, 0x00, 0x05,
+ 0x10, 0x0A, 0x0A, 0x0B, 0x0B, 0x17, 0x82, 0x01, 0x81, 0x06, 0x81, 0x03, 0x0E, 0x2C, 0x06, 0x12,
+ 0x28, 0x00, 0x00, 0x16, 0x02, 0x33, 0x13, 0x0A, 0x0A, 0x0B, 0x0B, 0x17, 0x82, 0x01, 0x0B, 0x06,
+ 0x29, 0x00, 0x19, 0x0A, 0x3C, 0x00, 0x23, 0x2A, 0x00, 0x00, 0x14, 0x82, 0x0C, 0x05, 0x13, 0x0A,
+ 0x0A, 0x0B, 0x0B, 0x39, 0x8A, 0x00, 0x02, 0x32, 0x20, 0x1E, 0x82, 0x0C, 0x01, 0x1D, 0x2D, 0x8C,
+ 0x00, 0x07, 0x37, 0x00, 0x3B, 0x0F, 0x00, 0x00, 0x02, 0x15, 0x8A, 0x00, 0x02, 0x15, 0x16, 0x10,
+ 0x83, 0x00, 0x01, 0x07, 0x27, 0x8A, 0x00, 0x01, 0x26, 0x06, 0x85, 0x00, 0x00, 0x13, 0x8A, 0x00,
+ 0x01, 0x3A, 0x24, 0x8B, 0x00,
+};
+
+static const ST7735_RLEImage sunny_day_img = {
+  20, 20, 8, 64, sunny_day_pal, sunny_day_rle
+};
+
+static const uint16_t sunny_day_blink_pal[] = {
+ 0xBBA1, 0x1DDD, 0x163E, 0x1D9D, 0x0E7E, 0x165E, 0x1DBD, 0x1DFE,
+ 0x1E1E, 0x0E9E, 0x253C, 0x255D, 0x257D, 0x0EBF, 0x1DFD, 0xABC4,
+ 0x06BF, 0x161E, 0x1D7D, 0x255C, 0x0E9F, 0x1E5C, 0x24DC, 0x251C,
+ 0x25FB, 0x2CDC, 0x4536, 0x4D36, 0x5C53, 0x64F0, 0x742E, 0x746E,
+ 0x8C4A, 0x8C6A, 0x9447, 0x9BE7, 0xA3C5, 0xABE4, 0xABE5, 0xB3C3,
+ 0xB3C4, 0xBBA2,
+};
+
+static const uint8_t sunny_day_blink_rle[] = {
+ 0xC3, 0x00, 0x03, 0x0F, 0x21, 0x20, 0x28, 0x8D, 0x00, 0x07, 0x1B, 0x05, 0x09, 0x0D, 0x0D, 0x10,
+ 0x0D, 0x18, 0x8A, 0x00, 0x00, 0x25, 0x82, 0x04, 0x81, 0x09, 0x03, 0x14, 0x0D, 0x10, 0x22, 0x88,
+ 0x00, 0x02, 0x1D, 0x02, 0x02, 0x82, 0x05, 0x82, 0x04, 0x81, 0x09, 0x00, 0x15, 0x87, 0x00, 0x81,
+ 0x08, 0x82, 0x02, 0x82, 0x05, 0x82, 0x04, 0x00, 0x09, 0x87, 0x00, 0x06, 0x01, 0x0E, 0x07, 0x07,
+ 0x08, 0x08, 0x11, 0x82, 0x02, 0x81, 0x05, 0x86, 0x00, 0x00, 0x26, 0x82, 0x01, 0x05, 0x0E, 0x07,
+ 0x07, 0x08, 0x08, 0x11, 0x82, 0x02, 0x86, 0x00, 0x01, 0x0F, 0x03, 0x82, 0x06, 0x82, 0x01, 0x04,
+ 0x0E, 0x07, 0x07, 0x08, 0x08, 0x87, 0x00, 0x83, 0x03, 0x81, 0x06, 0x82, 0x01, 0x02, 0x0E, 0x07,
+ 0x07, 0x87, 0x00, 0x81, 0x0B, 0x81, 0x0C, 0x00, 0x12, 0x82, 0x03, 0x81, 0x06, 0x81, 0x01, 0x87,
+ 0x00, 0x06, 0x1F, 0x13, 0x0B, 0x0B, 0x0C, 0x0C, 0x12, 0x82, 0x03, 0x01, 0x06, 0x1A, 0x82, 0x00,
+ 0x00, 0x29, 0x84, 0x00, 0x00, 0x27, 0x82, 0x0A, 0x05, 0x13, 0x0B, 0x0B, 0x0C, 0x0C, 0x23, 0x8A,
+ 0x00, 0x02, 0x1E, 0x19, 0x17, 0x82, 0x0A, 0x01, 0x16, 0x1C, 0x8E, 0x00, 0x01, 0x24, 0x0F, 0xC4,
+ 0x00,
+};
+
+static const ST7735_RLEImage sunny_day_blink_img = {
+  20, 20, 8, 42, sunny_day_blink_pal, sunny_day_blink_rle
+};
+
+static const uint16_t rainy_pal[] = {
+ 0x39C7, 0xE71A, 0xD637, 0xE6FA, 0xE544, 0x4208, 0x5AAA, 0x5ACB,
+ 0xB554, 0xD658, 0xDED9, 0x52AA, 0x62A6, 0xA4F2, 0xDE78, 0xDE99,
+ 0x4A27, 0x62EB, 0x6AC6, 0x6B4C, 0x734D, 0x736D, 0x738D, 0x7BCE,
+ 0x83CE, 0x840F, 0x8B66, 0x9BC5, 0xA4F3, 0xA513, 0xBD74, 0xBD95,
+ 0xBDD6, 0xC4A5, 0xC5F6, 0xCDF6, 0xD505, 0xD678, 0xDD44, 0xE6D9,
+};
+
+static const uint8_t rainy_rle[] = {
+ 0x88, 0x00, 0x01, 0x14, 0x15, 0x8F, 0x00, 0x05, 0x23, 0x0E, 0x01, 0x01, 0x25, 0x1F, 0x8C, 0x00,
+ 0x00, 0x1E, 0x85, 0x01, 0x00, 0x08, 0x8A, 0x00, 0x00, 0x16, 0x87, 0x01, 0x00, 0x11, 0x86, 0x00,
+ 0x03, 0x08, 0x02, 0x02, 0x0A, 0x82, 0x01, 0x81, 0x03, 0x82, 0x01, 0x03, 0x0A, 0x02, 0x02, 0x0D,
+ 0x82, 0x00, 0x00, 0x08, 0x84, 0x01, 0x04, 0x03, 0x02, 0x0F, 0x0F, 0x02, 0x85, 0x01, 0x02, 0x0D,
+ 0x00, 0x05, 0x85, 0x01, 0x00, 0x02, 0x83, 0x01, 0x00, 0x02, 0x84, 0x01, 0x02, 0x03, 0x00, 0x19,
+ 0x82, 0x01, 0x02, 0x27, 0x02, 0x09, 0x85, 0x01, 0x02, 0x09, 0x02, 0x03, 0x82, 0x01, 0x01, 0x18,
+ 0x20, 0x82, 0x01, 0x00, 0x0E, 0x89, 0x01, 0x00, 0x09, 0x82, 0x01, 0x01, 0x1C, 0x22, 0x8D, 0x01,
+ 0x00, 0x03, 0x82, 0x01, 0x01, 0x1D, 0x06, 0x91, 0x01, 0x01, 0x06, 0x00, 0x90, 0x01, 0x03, 0x03,
+ 0x00, 0x00, 0x05, 0x82, 0x01, 0x00, 0x0A, 0x8B, 0x01, 0x00, 0x05, 0x83, 0x00, 0x03, 0x07, 0x0B,
+ 0x00, 0x17, 0x85, 0x01, 0x03, 0x13, 0x00, 0x0B, 0x07, 0x89, 0x00, 0x05, 0x07, 0x03, 0x01, 0x01,
+ 0x03, 0x06, 0x8B, 0x00, 0x00, 0x24, 0x87, 0x00, 0x00, 0x04, 0x88, 0x00, 0x02, 0x0C, 0x04, 0x21,
+ 0x86, 0x00, 0x01, 0x04, 0x26, 0x87, 0x00, 0x02, 0x0C, 0x04, 0x04, 0x86, 0x00, 0x81, 0x04, 0x88,
+ 0x00, 0x01, 0x1B, 0x10, 0x86, 0x00, 0x01, 0x1A, 0x12, 0x97, 0x00,
+};
+
+static const ST7735_RLEImage rainy_img = {
+  20, 20, 8, 40, rainy_pal, rainy_rle
+};
+
+static const uint16_t rainy_blink_pal[] = {
+ 0x39C7, 0xE71A, 0xD637, 0xE6FA, 0x41E7, 0x4208, 0x5AAA, 0x5ACB,
+ 0xB554, 0xD658, 0xDED9, 0x52AA, 0xA4F2, 0xDD24, 0xDE78, 0xDE99,
+ 0xE544, 0x62EB, 0x6B4C, 0x734D, 0x736D, 0x738D, 0x7B06, 0x7BCE,
+ 0x83CE, 0x840F, 0x8B66, 0xA4F3, 0xA513, 0xBD74, 0xBD95, 0xBDD6,
+ 0xC5F6, 0xCCE5, 0xCDF6, 0xD678, 0xE6D9,
+};
+
+static const uint8_t rainy_blink_rle[] = {
+ 0x88, 0x00, 0x01, 0x13, 0x14, 0x8F, 0x00, 0x05, 0x22, 0x0E, 0x01, 0x01, 0x23, 0x1E, 0x8C, 0x00,
+ 0x00, 0x1D, 0x85, 0x01, 0x00, 0x08, 0x8A, 0x00, 0x00, 0x15, 0x87, 0x01, 0x00, 0x11, 0x86, 0x00,
+ 0x03, 0x08, 0x02, 0x02, 0x0A, 0x82, 0x01, 0x81, 0x03, 0x82, 0x01, 0x03, 0x0A, 0x02, 0x02, 0x0C,
+ 0x82, 0x00, 0x00, 0x08, 0x84, 0x01, 0x04, 0x03, 0x02, 0x0F, 0x0F, 0x02, 0x85, 0x01, 0x02, 0x0C,
+ 0x00, 0x05, 0x85, 0x01, 0x00, 0x02, 0x83, 0x01, 0x00, 0x02, 0x84, 0x01, 0x02, 0x03, 0x00, 0x19,
+ 0x82, 0x01, 0x02, 0x24, 0x02, 0x09, 0x85, 0x01, 0x02, 0x09, 0x02, 0x03, 0x82, 0x01, 0x01, 0x18,
+ 0x1F, 0x82, 0x01, 0x00, 0x0E, 0x89, 0x01, 0x00, 0x09, 0x82, 0x01, 0x01, 0x1B, 0x20, 0x8D, 0x01,
+ 0x00, 0x03, 0x82, 0x01, 0x01, 0x1C, 0x06, 0x91, 0x01, 0x01, 0x06, 0x00, 0x90, 0x01, 0x03, 0x03,
+ 0x00, 0x00, 0x05, 0x82, 0x01, 0x00, 0x0A, 0x8B, 0x01, 0x00, 0x05, 0x83, 0x00, 0x03, 0x07, 0x0B,
+ 0x00, 0x17, 0x85, 0x01, 0x03, 0x12, 0x00, 0x0B, 0x07, 0x89, 0x00, 0x05, 0x07, 0x03, 0x01, 0x01,
+ 0x03, 0x06, 0x8B, 0x00, 0x00, 0x04, 0x82, 0x00, 0x00, 0x04, 0x92, 0x00, 0x01, 0x21, 0x16, 0x91,
+ 0x00, 0x01, 0x0D, 0x10, 0x91, 0x00, 0x01, 0x0D, 0x10, 0x91, 0x00, 0x01, 0x04, 0x1A, 0x88, 0x00,
+};
+
+static const ST7735_RLEImage rainy_blink_img = {
+  20, 20, 8, 37, rainy_blink_pal, rainy_blink_rle
+};
+
+// Blink frame differences, see ShowIconDelta() in WeatherDisplay.c
+typedef struct {
+  uint8_t x, y, len;    // changed run: len pixels from column x of row y (0 = top)
+  uint16_t first;       // index of its first color in the pixel table
+} IconSpan;
+typedef struct {
+  uint8_t numSpans;
+  const IconSpan *spans;
+  const uint16_t *pixels;  // new colors, span after span
+} IconDelta;
+
+// cloud_day -> cloud_day_blink: 143 of 400 pixels sent
+static const uint16_t cloud_day_blink_delta_px[] = {
+ 0xD616, 0xD5F5, 0xC426, 0xCDF5, 0xCDF5, 0xC426, 0xCDD4, 0xD636,
+ 0xBBA2, 0xD656, 0xE71A, 0xE71A, 0xC426, 0xBC05, 0xD637, 0xD637,
+ 0xBC05, 0xC448, 0xE71A, 0xE71A, 0xDE77, 0xCD70, 0xD635, 0xE71A,
+ 0xDEB9, 0xE6D9, 0xD658, 0xE6F9, 0xE6F9, 0xD678, 0xE6D9, 0xDEB9,
+ 0xE71A, 0xDE57, 0xCD70, 0xBBA2, 0xBBE4, 0xE6FA, 0xE71A, 0xE71A,
+ 0xDEB9, 0xDE78, 0xDEB9, 0xDE98, 0xD678, 0xDED9, 0xE71A, 0xE71A,
+ 0xE6FA, 0xC426, 0xDE76, 0xE71A, 0xDE78, 0xDEB9, 0xE6FA, 0xDE98,
+ 0xDEB9, 0xE6FA, 0xDE99, 0xDE78, 0xE71A, 0xE6FA, 0xDE96, 0xE71A,
+ 0xDE78, 0xD637, 0xD637, 0xDE78, 0xE6FA, 0xE6FA, 0xDE78, 0xD637,
+ 0xD637, 0xDE98, 0xE71A, 0xE71A, 0xD5B0, 0xDE99, 0xD678, 0xD678,
+ 0xE6FA, 0xDE99, 0xD5B0, 0xBBA1, 0xDE78, 0xE6FA, 0xDEB9, 0xDEB9,
+ 0xE6FA, 0xDE78, 0xBBE3, 0xCD2E, 0xD658, 0xD657, 0xDE98, 0xDED9,
+ 0xC4AA, 0xD635, 0xE6D9, 0xE6FA, 0xE6F9, 0xD678, 0xD637, 0xE6FA,
+ 0xD615, 0xE6D8, 0xDE78, 0xD658, 0xE6FA, 0xE6D8, 0xE6FA, 0xE6FA,
+ 0xDEB7, 0xE6D8, 0xD5B0, 0xCD2C, 0xBBA2, 0xBBC2, 0xD58F, 0xD54E,
+ 0xBBA1, 0xDE97, 0xE71A, 0xE6FA, 0xD5F2, 0xD5F2, 0xDE96, 0xBBA1,
+ 0xC3E4, 0xBBC2, 0xBBA1, 0xCD0B, 0xCCEA, 0xBBA1, 0xBBC2, 0xC404,
+ 0xBBA1, 0xC446, 0xC425, 0xBBA2, 0xC446, 0xC404, 0xBBA2,
+};
+static const IconSpan cloud_day_blink_delta_spans[] = {
+  { 4,  0,  2,   0},
+  { 8,  0,  4,   2},
+  {14,  0,  3,   6},
+  { 3,  1,  6,   9},
+  {11,  1,  6,  15},
+  { 1,  2,  7,  21},
+  {12,  2,  8,  28},
+  { 0,  3,  7,  36},
+  {13,  3,  7,  43},
+  { 0,  4,  6,  50},
+  {14,  4,  6,  56},
+  { 0,  5,  6,  62},
+  { 9,  5,  2,  68},
+  {14,  5,  6,  70},
+  { 0,  6,  2,  76},
+  { 9,  6,  2,  78},
+  {17,  6,  3,  80},
+  { 0,  7,  2,  83},
+  { 7,  7,  2,  85},
+  {11,  7,  2,  87},
+  {18,  7,  2,  89},
+  { 0,  8,  1,  91},
+  { 7,  8,  1,  92},
+  {12,  8,  3,  93},
+  {19,  8,  1,  96},
+  { 0,  9,  1,  97},
+  { 4,  9,  1,  98},
+  { 7,  9,  1,  99},
+  {12,  9,  4, 100},
+  {19,  9,  1, 104},
+  { 0, 10,  1, 105},
+  { 4, 10,  1, 106},
+  {15, 10,  1, 107},
+  {19, 10,  1, 108},
+  { 0, 11,  1, 109},
+  { 4, 11,  1, 110},
+  {15, 11,  1, 111},
+  { 0, 12,  1, 112},
+  {19, 12,  1, 113},
+  { 0, 13,  1, 114},
+  {19, 13,  1, 115},
+  { 0, 14,  1, 116},
+  {19, 14,  1, 117},
+  { 1, 15,  1, 118},
+  {18, 15,  1, 119},
+  { 1, 16,  5, 120},
+  {14, 16,  1, 125},
+  {17, 16,  1, 126},
+  { 2, 17,  5, 127},
+  {13, 17,  5, 132},
+  { 7, 18,  1, 137},
+  {12, 18,  1, 138},
+  { 8, 19,  4, 139},
+};
+static const IconDelta cloud_day_blink_delta = {
+  53, cloud_day_blink_delta_spans, cloud_day_blink_delta_px
+};
+
+// cloud_day_blink -> cloud_day: 143 of 400 pixels sent
+static const uint16_t cloud_day_delta_px[] = {
+ 0xBBA1, 0xBBA1, 0xC4AB, 0xCDB3, 0xCDB3, 0xC489, 0xBBA1, 0xBBA1,
+ 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xC4CB, 0xD658, 0xD658,
+ 0xC4CB, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1,
+ 0xBBA1, 0xBBA1, 0xD5F5, 0xE6DA, 0xE6D9, 0xCDD4, 0xBBA1, 0xBBA1,
+ 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1,
+ 0xBBA1, 0xBBA1, 0xE6D9, 0xDED9, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1,
+ 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBE4, 0xBBA2, 0xCDD4,
+ 0xCD71, 0xBBC2, 0xBBE4, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1,
+ 0xCD50, 0xD616, 0xD5F5, 0xDEB9, 0xE71A, 0xE71A, 0xDE98, 0xD5F5,
+ 0xD616, 0xCD70, 0xBBA1, 0xBBA1, 0xBBA1, 0xCDD4, 0xD658, 0xD658,
+ 0xE71A, 0xCD91, 0xBBA1, 0xBBC2, 0xDEB9, 0xDEB9, 0xE6D9, 0xE6D9,
+ 0xE6D9, 0xDEB9, 0xBBC3, 0xD5D4, 0xDE78, 0xD658, 0xDE98, 0xDEB9,
+ 0xD5D3, 0xDEB9, 0xDEB9, 0xE71A, 0xE6FA, 0xD658, 0xD637, 0xDEB9,
+ 0xDED9, 0xE71A, 0xDE98, 0xDE78, 0xE71A, 0xE71A, 0xE71A, 0xE71A,
+ 0xE71A, 0xE71A, 0xE6B8, 0xE6F9, 0xC405, 0xC425, 0xE71A, 0xE6F9,
+ 0xBBA2, 0xE71A, 0xE71A, 0xE71A, 0xD5D1, 0xD5B0, 0xE71A, 0xBBE3,
+ 0xCCA9, 0xC425, 0xBBA1, 0xE6F9, 0xE6B7, 0xBBA1, 0xC425, 0xCCCA,
+ 0xBBE3, 0xCD4D, 0xCD0C, 0xCD0B, 0xE6D9, 0xE6D9, 0xCD2C,
+};
+static const IconSpan cloud_day_delta_spans[] = {
+  { 4,  0,  2,   0},
+  { 8,  0,  4,   2},
+  {14,  0,  3,   6},
+  { 3,  1,  6,   9},
+  {11,  1,  6,  15},
+  { 1,  2,  7,  21},
+  {12,  2,  8,  28},
+  { 0,  3,  7,  36},
+  {13,  3,  7,  43},
+  { 0,  4,  6,  50},
+  {14,  4,  6,  56},
+  { 0,  5,  6,  62},
+  { 9,  5,  2,  68},
+  {14,  5,  6,  70},
+  { 0,  6,  2,  76},
+  { 9,  6,  2,  78},
+  {17,  6,  3,  80},
+  { 0,  7,  2,  83},
+  { 7,  7,  2,  85},
+  {11,  7,  2,  87},
+  {18,  7,  2,  89},
+  { 0,  8,  1,  91},
+  { 7,  8,  1,  92},
+  {12,  8,  3,  93},
+  {19,  8,  1,  96},
+  { 0,  9,  1,  97},
+  { 4,  9,  1,  98},
+  { 7,  9,  1,  99},
+  {12,  9,  4, 100},
+  {19,  9,  1, 104},
+  { 0, 10,  1, 105},
+  { 4, 10,  1, 106},
+  {15, 10,  1, 107},
+  {19, 10,  1, 108},
+  { 0, 11,  1, 109},
+  { 4, 11,  1, 110},
+  {15, 11,  1, 111},
+  { 0, 12,  1, 112},
+  {19, 12,  1, 113},
+  { 0, 13,  1, 114},
+  {19, 13,  1, 115},
+  { 0, 14,  1, 116},
+  {19, 14,  1, 117},
+  { 1, 15,  1, 118},
+  {18, 15,  1, 119},
+  { 1, 16,  5, 120},
+  {14, 16,  1, 125},
+  {17, 16,  1, 126},
+  { 2, 17,  5, 127},
+  {13, 17,  5, 132},
+  { 7, 18,  1, 137},
+  {12, 18,  1, 138},
+  { 8, 19,  4, 139},
+};
+static const IconDelta cloud_day_delta = {
+  53, cloud_day_delta_spans, cloud_day_delta_px
+};
+
+// sunny_day -> sunny_day_blink: 53 of 400 pixels sent
+static const uint16_t sunny_day_blink_delta_px[] = {
+ 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1,
+ 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1,
+ 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1,
+ 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1,
+ 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA2, 0xBBA1, 0xBBA1,
+ 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1,
+ 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1, 0xBBA1,
+};
+static const IconSpan sunny_day_blink_delta_spans[] = {
+  {12,  0,  2,   0},
+  { 5,  1,  2,   2},
+  {12,  1,  2,   4},
+  { 5,  2,  3,   6},
+  {11,  2,  3,   9},
+  { 6,  3,  2,  12},
+  {12,  3,  1,  14},
+  {16,  5,  3,  15},
+  { 0,  6,  3,  18},
+  {16,  6,  2,  21},
+  { 0,  7,  4,  23},
+  { 2,  8,  1,  27},
+  { 3, 12,  1,  28},
+  {16, 12,  4,  29},
+  { 2, 13,  2,  33},
+  {17, 13,  3,  35},
+  { 1, 14,  2,  38},
+  { 7, 16,  1,  40},
+  {13, 16,  2,  41},
+  { 6, 17,  3,  43},
+  {13, 17,  2,  46},
+  { 6, 18,  2,  48},
+  {14, 18,  1,  50},
+  { 6, 19,  2,  51},
+};
+static const IconDelta sunny_day_blink_delta = {
+  24, sunny_day_blink_delta_spans, sunny_day_blink_delta_px
+};
+
+// sunny_day_blink -> sunny_day: 53 of 400 pixels sent
+static const uint16_t sunny_day_delta_px[] = {
+ 0x0E9E, 0x5D51, 0x1E3B, 0xABE4, 0x165E, 0x0E7E, 0x6CB0, 0x1DFE,
+ 0xB3A2, 0x7C6D, 0x1D9D, 0xB3C3, 0x1D9D, 0xA406, 0x7C4D, 0xB3C3,
+ 0x2DF9, 0x2E39, 0x8C6A, 0x06BF, 0xBBA2, 0x257D, 0x1DBD, 0x3559,
+ 0x1DFE, 0x165E, 0x5D31, 0xABC4, 0xABE4, 0x54D3, 0x1DBD, 0x161E,
+ 0x3DB7, 0x0E5E, 0x0E7E, 0xB3C4, 0x255D, 0xA3E5, 0x3519, 0x4CF5,
+ 0x8C8A, 0x0E7E, 0xBBA2, 0xBBA2, 0x0E5E, 0xABE4, 0x1DFE, 0x3D97,
+ 0x3D38, 0x1DBD, 0x255C, 0x9C07, 0x353A,
+};
+static const IconSpan sunny_day_delta_spans[] = {
+  {12,  0,  2,   0},
+  { 5,  1,  2,   2},
+  {12,  1,  2,   4},
+  { 5,  2,  3,   6},
+  {11,  2,  3,   9},
+  { 6,  3,  2,  12},
+  {12,  3,  1,  14},
+  {16,  5,  3,  15},
+  { 0,  6,  3,  18},
+  {16,  6,  2,  21},
+  { 0,  7,  4,  23},
+  { 2,  8,  1,  27},
+  { 3, 12,  1,  28},
+  {16, 12,  4,  29},
+  { 2, 13,  2,  33},
+  {17, 13,  3,  35},
+  { 1, 14,  2,  38},
+  { 7, 16,  1,  40},
+  {13, 16,  2,  41},
+  { 6, 17,  3,  43},
+  {13, 17,  2,  46},
+  { 6, 18,  2,  48},
+  {14, 18,  1,  50},
+  { 6, 19,  2,  51},
+};
+static const IconDelta sunny_day_delta = {
+  24, sunny_day_delta_spans, sunny_day_delta_px
+};
+
+// rainy -> rainy_blink: 25 of 400 pixels sent
+static const uint16_t rainy_blink_delta_px[] = {
+ 0x41E7, 0x41E7, 0x39C7, 0x39C7, 0x39C7, 0x39C7, 0xCCE5, 0x7B06,
+ 0x39C7, 0x39C7, 0x39C7, 0x39C7, 0x39C7, 0xDD24, 0xE544, 0x39C7,
+ 0x39C7, 0x39C7, 0x39C7, 0xDD24, 0xE544, 0x39C7, 0x39C7, 0x41E7,
+ 0x8B66,
+};
+static const IconSpan rainy_blink_delta_spans[] = {
+  { 5, 15,  1,   0},
+  { 9, 15,  1,   1},
+  {14, 15,  1,   2},
+  { 4, 16,  3,   3},
+  { 9, 16,  2,   6},
+  {14, 16,  2,   8},
+  { 4, 17,  3,  10},
+  { 9, 17,  2,  13},
+  {14, 17,  2,  15},
+  { 5, 18,  2,  17},
+  { 9, 18,  2,  19},
+  {14, 18,  2,  21},
+  { 9, 19,  2,  23},
+};
+static const IconDelta rainy_blink_delta = {
+  13, rainy_blink_delta_spans, rainy_blink_delta_px
+};
+
+// rainy_blink -> rainy: 25 of 400 pixels sent
+static const uint16_t rainy_delta_px[] = {
+ 0xD505, 0x39C7, 0xE544, 0x62A6, 0xE544, 0xC4A5, 0x39C7, 0x39C7,
+ 0xE544, 0xDD44, 0x62A6, 0xE544, 0xE544, 0x39C7, 0x39C7, 0xE544,
+ 0xE544, 0x9BC5, 0x4A27, 0x39C7, 0x39C7, 0x8B66, 0x6AC6, 0x39C7,
+ 0x39C7,
+};
+static const IconSpan rainy_delta_spans[] = {
+  { 5, 15,  1,   0},
+  { 9, 15,  1,   1},
+  {14, 15,  1,   2},
+  { 4, 16,  3,   3},
+  { 9, 16,  2,   6},
+  {14, 16,  2,   8},
+  { 4, 17,  3,  10},
+  { 9, 17,  2,  13},
+  {14, 17,  2,  15},
+  { 5, 18,  2,  17},
+  { 9, 18,  2,  19},
+  {14, 18,  2,  21},
+  { 9, 19,  2,  23},
+};
+static const IconDelta rainy_delta = {
+  13, rainy_delta_spans, rainy_delta_px
+};
+
+// Icon assets, indexed by IconId
+enum IconId {
+  ICON_CLOUD_DAY,
+  ICON_SUNNY_DAY,
+  ICON_RAINY,
+  NUM_ICONS
+};
+#define ICON_RLE 1             // frames are ST7735_RLEImage
+typedef struct {
+  const char *name;
+  uint8_t id;             // enum IconId, its index in Icons[]
+  uint8_t w, h;           // size in pixels
+  uint8_t encoding;       // ICON_RLE
+  uint8_t numFrames;      // animation frames, 1 if it does not change
+  const ST7735_RLEImage *const *frames;
+  const IconDelta *const *toNext; // toNext[i]: frame i to the next one (the last to the first), 0 for one frame
+} IconAsset;
+static const ST7735_RLEImage *const cloud_day_frames[] = {&cloud_day_img, &cloud_day_blink_img};
+static const IconDelta *const cloud_day_steps[] = {&cloud_day_blink_delta, &cloud_day_delta};
+static const ST7735_RLEImage *const sunny_day_frames[] = {&sunny_day_img, &sunny_day_blink_img};
+static const IconDelta *const sunny_day_steps[] = {&sunny_day_blink_delta, &sunny_day_delta};
+static const ST7735_RLEImage *const rainy_frames[] = {&rainy_img, &rainy_blink_img};
+static const IconDelta *const rainy_steps[] = {&rainy_blink_delta, &rainy_delta};
+static const IconAsset Icons[NUM_ICONS] = {
+  {"cloud_day", ICON_CLOUD_DAY, 20, 20, ICON_RLE, 2, cloud_day_frames, cloud_day_steps},
+  {"sunny_day", ICON_SUNNY_DAY, 20, 20, ICON_RLE, 2, sunny_day_frames, sunny_day_steps},
+  {"rainy", ICON_RAINY, 20, 20, ICON_RLE, 2, rainy_frames, rainy_steps},
+};
+
+#endif // __BITMAPS_RLE_H__
@@ -0,0 +1,248 @@
+#	File: rle_icons.py
+#	Group 17
+#	Andrew Nguyen, Anton Tran, Tommy Troung, Abass Mir
+#	Functionallity: Host tool that reads the raw RGB565 icons in
+#	bitmaps.h and writes bitmaps_rle.h with run-length encoded,
+#	palette-indexed versions for ST7735_DrawRLEImage().
+#
+# Usage (from this folder): python rle_icons.py
+# Run it again whenever an icon in bitmaps.h changes.
+#
+# Encoded format (see ST7735_RLEImage in ST7735.h)
+#   palette: up to 16 colors -> 4-bit indices, else up to 256 -> 8-bit
+#   data:    a stream of tokens covering the image top row first
+#     0x00-0x7F  literal: (token+1) indices follow, one per byte for
+#                8-bit images, two per byte (high nibble first) for 4-bit
+#     0x80-0xFF  run: (token-0x80+1) copies of the index in the next byte
+#   Runs may continue from the end of one row into the next.
+#
+# An icon X can have animation frames X_blink or X_2, X_3, ... that
+# follow it in bitmaps.h.  For every step from one frame to the next
+# (and from the last back to X) an IconDelta table named after the
+# destination frame is written: X_blink_delta (pixels to send when
+# going from X to X_blink) and X_delta (going back).  Each lists the
+# changed runs of every row and the destination colors of those runs.
+#
+# Asset table: Icons[] holds one IconAsset per icon, in bitmaps.h
+# order and indexed by the generated enum IconId (ICON_X), with its
+# name, size, encoding, frame list and step deltas, so the program
+# looks an icon up by number instead of naming its arrays.
+
+import re
+
+SOURCE = 'bitmaps.h'
+OUTPUT = 'bitmaps_rle.h'
+ICON_W = 20
+ICON_H = 20
+MAXRUN = 128
+MAXGAP = 1      # unchanged pixels allowed inside one delta span
+FRAME = re.compile(r'^(\w+)_(blink|\d+)$')   # animation frame of an icon
+
+
+def read_icons(path):
+    text = open(path, encoding='latin-1').read()
+    icons = []
+    for m in re.finditer(r'const unsigned short (\w+)\[\] = \{(.*?)\};', text, re.S):
+        pixels = [int(v, 16) for v in re.findall(r'0x[0-9A-Fa-f]{4}', m.group(2))]
+        icons.append((m.group(1), pixels))
+    return icons
+
+
+def top_down(pixels, w, h):
+    # bitmaps.h stores rows bottom-up (BMP order)
+    rows = [pixels[r*w:(r+1)*w] for r in range(h)]
+    return [p for row in reversed(rows) for p in row]
+
+
+def make_palette(pixels):
+    counts = {}
+    for p in pixels:
+        counts[p] = counts.get(p, 0) + 1
+    # most frequent first, so the common colors get the small indices
+    return sorted(counts, key=lambda c: (-counts[c], c))
+
+
+def pack_indices(indices, bpp):
+    if bpp == 8:
+        return list(indices)
+    out = []
+    for i in range(0, len(indices), 2):
+        hi = indices[i]
+        lo = indices[i+1] if i+1 < len(indices) else 0
+        out.append((hi << 4) | lo)
+    return out
+
+
+def encode(indices, bpp):
+    out = []
+    literal = []
+
+    def flush_literal():
+        while literal:
+            chunk = literal[:MAXRUN]
+            del literal[:MAXRUN]
+            out.append(len(chunk) - 1)
+            out.extend(pack_indices(chunk, bpp))
+
+    i = 0
+    while i < len(indices):
+        run = 1
+        while i + run < len(indices) and indices[i+run] == indices[i] and run < MAXRUN:
+            run += 1
+        if run >= 3 or (run == 2 and not literal):
+            flush_literal()
+            out.append(0x80 + run - 1)
+            out.append(indices[i])
+        else:
+            literal.extend(indices[i:i+run])
+        i += run
+    flush_literal()
+    return out
+
+
+def delta_spans(old, new, w, h):
+    spans = []
+    for y in range(h):
+        changed = [x for x in range(w) if old[y*w + x] != new[y*w + x]]
+        start = None
+        for x in changed:
+            if start is None:
+                start = last = x
+            elif x - last - 1 <= MAXGAP:
+                last = x
+            else:
+                spans.append((start, y, last - start + 1))
+                start = last = x
+        if start is not None:
+            spans.append((start, y, last - start + 1))
+    return spans
+
+
+def c_delta(name, old, new, w, h):
+    spans = delta_spans(old, new, w, h)
+    pixels = []
+    entries = []
+    for x, y, length in spans:
+        entries.append('  {%2d, %2d, %2d, %3d},' % (x, y, length, len(pixels)))
+        pixels.extend(new[y*w + x:y*w + x + length])
+    text = c_array('uint16_t', name + '_px', pixels, 8, '0x%04X')
+    text += 'static const IconSpan %s_spans[] = {\n%s\n};\n' % (name, '\n'.join(entries))
+    text += ('static const IconDelta %s = {\n  %d, %s_spans, %s_px\n};\n'
+             % (name, len(spans), name, name))
+    return text, len(pixels)
+
+
+def c_array(ctype, name, values, per_line, fmt):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append(' ' + ', '.join(fmt % v for v in values[i:i+per_line]) + ',')
+    return 'static const %s %s[] = {\n%s\n};\n' % (ctype, name, '\n'.join(lines))
+
+
+def group_frames(names):
+    # base icon -> its frames in file order, the base first
+    assets = {}
+    for name in names:
+        m = FRAME.match(name)
+        if m and m.group(1) in assets:
+            assets[m.group(1)].append(name)
+        else:
+            assets[name] = [name]
+    return assets
+
+
+def c_assets(assets):
+    ids = ['ICON_' + name.upper() for name in assets]
+    text = ('// Icon assets, indexed by IconId\n'
+            'enum IconId {\n%s\n  NUM_ICONS\n};\n'
+            '#define ICON_RLE 1             // frames are ST7735_RLEImage\n'
+            'typedef struct {\n'
+            '  const char *name;\n'
+            '  uint8_t id;             // enum IconId, its index in Icons[]\n'
+            '  uint8_t w, h;           // size in pixels\n'
+            '  uint8_t encoding;       // ICON_RLE\n'
+            '  uint8_t numFrames;      // animation frames, 1 if it does not change\n'
+            '  const ST7735_RLEImage *const *frames;\n'
+            '  const IconDelta *const *toNext; // toNext[i]: frame i to the next one (the last to the first), 0 for one frame\n'
+            '} IconAsset;\n' % '\n'.join('  %s,' % i for i in ids))
+    entries = []
+    for (name, names), ident in zip(assets.items(), ids):
+        text += ('static const ST7735_RLEImage *const %s_frames[] = {%s};\n'
+                 % (name, ', '.join('&%s_img' % f for f in names)))
+        steps = '0'
+        if len(names) > 1:
+            steps = name + '_steps'
+            text += ('static const IconDelta *const %s[] = {%s};\n'
+                     % (steps, ', '.join('&%s_delta' % names[(i+1) % len(names)]
+                                         for i in range(len(names)))))
+        entries.append('  {"%s", %s, %d, %d, ICON_RLE, %d, %s_frames, %s},'
+                       % (name, ident, ICON_W, ICON_H, len(names), name, steps))
+    text += ('static const IconAsset Icons[NUM_ICONS] = {\n%s\n};\n'
+             % '\n'.join(entries))
+    return text
+
+
+def main():
+    icons = read_icons(SOURCE)
+    parts = []
+    raw_bytes = 0
+    rle_bytes = 0
+    frames = {}
+    for name, pixels in icons:
+        assert len(pixels) == ICON_W*ICON_H, name
+        pixels = top_down(pixels, ICON_W, ICON_H)
+        frames[name] = pixels
+        palette = make_palette(pixels)
+        assert len(palette) <= 256, name
+        bpp = 4 if len(palette) <= 16 else 8
+        lookup = {c: i for i, c in enumerate(palette)}
+        data = encode([lookup[p] for p in pixels], bpp)
+        raw_bytes += 2*len(pixels)
+        rle_bytes += 2*len(palette) + len(data)
+        parts.append(c_array('uint16_t', name + '_pal', palette, 8, '0x%04X'))
+        parts.append(c_array('uint8_t', name + '_rle', data, 16, '0x%02X'))
+        parts.append('static const ST7735_RLEImage %s_img = {\n'
+                     '  %d, %d, %d, %d, %s_pal, %s_rle\n};\n'
+                     % (name, ICON_W, ICON_H, bpp, len(palette), name, name))
+
+    deltas = ['// Blink frame differences, see ShowIconDelta() in WeatherDisplay.c\n'
+              'typedef struct {\n'
+              '  uint8_t x, y, len;    // changed run: len pixels from column x of row y (0 = top)\n'
+              '  uint16_t first;       // index of its first color in the pixel table\n'
+              '} IconSpan;\n'
+              'typedef struct {\n'
+              '  uint8_t numSpans;\n'
+              '  const IconSpan *spans;\n'
+              '  const uint16_t *pixels;  // new colors, span after span\n'
+              '} IconDelta;\n']
+    assets = group_frames(frames)
+    for names in assets.values():
+        if len(names) < 2:
+            continue
+        for i, src in enumerate(names):
+            dst = names[(i+1) % len(names)]
+            text, count = c_delta(dst + '_delta', frames[src], frames[dst], ICON_W, ICON_H)
+            deltas.append('// %s -> %s: %d of %d pixels sent\n%s'
+                          % (src, dst, count, ICON_W*ICON_H, text))
+    parts.extend(deltas)
+    parts.append(c_assets(assets))
+
+    with open(OUTPUT, 'w', newline='\r\n') as f:
+        f.write('/*\n'
+                '\t\tFile: bitmaps_rle.h\n'
+                '\t\tGroup 17\n'
+                '\t\tAndrew Nguyen, Anton Tran, Tommy Troung, Abass Mir\n'
+                '\t\tFunctionallity: Run-length encoded, palette-indexed versions\n'
+                '\t\tof the weather icons in bitmaps.h for ST7735_DrawRLEImage().\n'
+                '\t\tGenerated by rle_icons.py -- do not edit by hand.\n'
+                '*/ \n\n')
+        f.write('// %d bytes raw RGB565, %d bytes encoded (palettes included)\n\n'
+                % (raw_bytes, rle_bytes))
+        f.write('#ifndef __BITMAPS_RLE_H__\n#define __BITMAPS_RLE_H__\n'
+                '#include <stdint.h>\n#include "ST7735.h"\n\n')
+        f.write('\n'.join(parts))
+        f.write('\n#endif // __BITMAPS_RLE_H__\n')
+
+
+if __name__ == '__main__':
+    main()